@@ -0,0 +1,568 @@
+#include "AllocationCounter.h"
+#include "BatchGenerator.h"
+#include "CellUnitConverter.h"
+#include "ChunkedGenerator.h"
+#include "Grid.h"
+#include "GridRay.h"
+#include "LabyrinthBuilder.h"
+#include "LabyrinthFile.h"
+#include "LabyrinthStats.h"
+#include "OccupancyBitboard.h"
+#include "Random.h"
+#include "SummedAreaTable.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+// Every benchmark uses fixed seeds, so each run measures the same labyrinths.
+// Pass --benchmark_format=json or --benchmark_out=<file> for machine readable results.
+
+using namespace LabyrinthGeneration;
+
+namespace
+{
+    const double CELL_UNIT{ 2.0 };
+
+    // Which executable produced a set of results, since labyrinth_benchmarks_other_layout runs the same benchmarks.
+    const bool IS_LAYOUT_CONTEXT_ADDED{ (benchmark::AddCustomContext("grid_layout", GridLayout::IS_ROW_MAJOR ? "row_major" : "tiled"), true) };
+
+    // Square room of the given side in meters, with a door in the center of each wall.
+    Room makeRoom(double side)
+    {
+        double half{ side / 2 };
+
+        return Room
+        {
+            Vector3{ side, side, 3 },
+            {
+                PlaneTransform{ Vector3{ half, 0, 0 }, VectorXY{ 0, -1 } },
+                PlaneTransform{ Vector3{ half, side, 0 }, VectorXY{ 0, 1 } },
+                PlaneTransform{ Vector3{ 0, half, 0 }, VectorXY{ -1, 0 } },
+                PlaneTransform{ Vector3{ side, half, 0 }, VectorXY{ 1, 0 } },
+            }
+        };
+    }
+
+    // Arguments: grid side in cells, room count, room side in meters, threads (zero is one per hardware thread).
+    void BM_Build(benchmark::State& state)
+    {
+        int size{ static_cast<int>(state.range(0)) };
+        int roomCount{ static_cast<int>(state.range(1)) };
+
+        LabyrinthBuilder builder{ VectorIntXY{ size, size }, roomCount, CELL_UNIT, makeRoom(static_cast<double>(state.range(2))), 1u };
+        builder.setLogLevel(LogLevel::None);
+        builder.setDistanceFieldThreadCount(static_cast<std::size_t>(state.range(3)));
+
+        std::uint64_t allocationCount{ 0 };
+        std::uint64_t roomsPlaced{ 0 };
+
+        for (auto _ : state)
+        {
+            std::uint64_t allocationsBefore{ getThreadAllocationCount() };
+            const LabyrinthResult& result{ builder.build() };
+            allocationCount += getThreadAllocationCount() - allocationsBefore;
+            roomsPlaced += result.rooms.size();
+
+            benchmark::DoNotOptimize(result.distanceField.getDistance(VectorIntXY{ 0, 0 }));
+        }
+
+        std::int64_t cellCount{ std::int64_t{ size } * size };
+        state.counters["rooms_per_second"] = benchmark::Counter(static_cast<double>(roomsPlaced), benchmark::Counter::kIsRate);
+        state.counters["cells_per_second"] = benchmark::Counter(static_cast<double>(cellCount * state.iterations()), benchmark::Counter::kIsRate);
+        state.counters["allocations_per_build"] = static_cast<double>(allocationCount) / static_cast<double>(state.iterations());
+    }
+
+    // Grid sizes.
+    BENCHMARK(BM_Build)
+        ->ArgNames({ "size", "rooms", "room_m", "threads" })
+        ->Args({ 64, 16, 6, 1 })
+        ->Args({ 256, 16, 6, 1 })
+        ->Args({ 1024, 16, 6, 1 })
+        ->Args({ 4096, 16, 6, 1 })
+        ->Args({ 8192, 16, 6, 1 })
+        // Room counts.
+        ->Args({ 1024, 128, 6, 1 })
+        ->Args({ 1024, 1024, 6, 1 })
+        // More rooms than fit, which stops once no room fits anywhere.
+        ->Args({ 64, 1000, 6, 1 })
+        // Room sizes.
+        ->Args({ 1024, 128, 2, 1 })
+        ->Args({ 1024, 128, 16, 1 })
+        // Parallel distance field propagation.
+        ->Args({ 1024, 20, 6, 0 })
+        ->Args({ 4096, 20, 6, 0 })
+        ->Unit(benchmark::kMillisecond);
+
+    // Keeping the distance field up to date after every room against routing each hallway with a search from the room's doors.
+    // Arguments: grid side in cells, room count, whether distance field updates are deferred to the end of the build.
+    void BM_BuildUpdateMode(benchmark::State& state)
+    {
+        int size{ static_cast<int>(state.range(0)) };
+        int roomCount{ static_cast<int>(state.range(1)) };
+
+        LabyrinthBuilder builder{ VectorIntXY{ size, size }, roomCount, CELL_UNIT, makeRoom(6), 1u };
+        builder.setLogLevel(LogLevel::None);
+        builder.setDistanceFieldThreadCount(1);
+        builder.setDistanceFieldUpdateMode(state.range(2) != 0 ? DistanceFieldUpdateMode::Deferred : DistanceFieldUpdateMode::Incremental);
+
+        std::uint64_t roomsPlaced{ 0 };
+
+        for (auto _ : state)
+        {
+            const LabyrinthResult& result{ builder.build() };
+            roomsPlaced += result.rooms.size();
+
+            benchmark::DoNotOptimize(result.distanceField.getDistance(VectorIntXY{ 0, 0 }));
+        }
+
+        state.counters["rooms_per_second"] = benchmark::Counter(static_cast<double>(roomsPlaced), benchmark::Counter::kIsRate);
+    }
+
+    BENCHMARK(BM_BuildUpdateMode)
+        ->ArgNames({ "size", "rooms", "deferred" })
+        ->ArgsProduct({ { 1024 }, { 128, 1024 }, { 0, 1 } })
+        ->Args({ 4096, 128, 0 })
+        ->Args({ 4096, 128, 1 })
+        ->Unit(benchmark::kMillisecond);
+
+    // Search rays against the free space index. Hallways are routed with deferred distance field updates,
+    // so placement is a larger share of the build. The small grids fill up before every room is placed.
+    // Arguments: grid side in cells, room count, whether rooms are placed with the free space index.
+    void BM_PlacementStrategy(benchmark::State& state)
+    {
+        int size{ static_cast<int>(state.range(0)) };
+        int roomCount{ static_cast<int>(state.range(1)) };
+
+        LabyrinthBuilder builder{ VectorIntXY{ size, size }, roomCount, CELL_UNIT, makeRoom(6), 1u };
+        builder.setLogLevel(LogLevel::None);
+        builder.setDistanceFieldThreadCount(1);
+        builder.setDistanceFieldUpdateMode(DistanceFieldUpdateMode::Deferred);
+        builder.setPlacementStrategy(state.range(2) != 0 ? PlacementStrategy::FreeSpaceIndex : PlacementStrategy::SearchRay);
+
+        std::uint64_t roomsPlaced{ 0 };
+        std::uint64_t failedAttempts{ 0 };
+        std::chrono::duration<double> spawnSearchTime{};
+
+        for (auto _ : state)
+        {
+            const LabyrinthResult& result{ builder.build() };
+            roomsPlaced += result.rooms.size();
+            failedAttempts += result.stats.placement.failedAttempts;
+            spawnSearchTime += result.stats.spawnSearchTime;
+
+            benchmark::DoNotOptimize(result.distanceField.getDistance(VectorIntXY{ 0, 0 }));
+        }
+
+        double iterations{ static_cast<double>(state.iterations()) };
+        state.counters["rooms"] = static_cast<double>(roomsPlaced) / iterations;
+        state.counters["failed_attempts"] = static_cast<double>(failedAttempts) / iterations;
+        state.counters["search_us_per_room"] = std::chrono::duration<double, std::micro>{ spawnSearchTime }.count() / static_cast<double>(roomsPlaced);
+    }
+
+    BENCHMARK(BM_PlacementStrategy)
+        ->ArgNames({ "size", "rooms", "index" })
+        ->ArgsProduct({ { 64, 256 }, { 1000 }, { 0, 1 } })
+        ->ArgsProduct({ { 1024, 4096 }, { 128 }, { 0, 1 } })
+        ->Unit(benchmark::kMillisecond);
+
+    // Time one phase of build(), taken from the build's statistics. Arguments: grid side in cells, room count.
+    // Reported per build, with the time per call in a counter.
+    void BM_BuildPhase(benchmark::State& state, std::chrono::nanoseconds LabyrinthStats::* phaseTime)
+    {
+        if constexpr (!ARE_STATS_ENABLED)
+        {
+            state.SkipWithError("Build statistics are compiled out.");
+            return;
+        }
+
+        int size{ static_cast<int>(state.range(0)) };
+        int roomCount{ static_cast<int>(state.range(1)) };
+
+        LabyrinthBuilder builder{ VectorIntXY{ size, size }, roomCount, CELL_UNIT, makeRoom(6), 1u };
+        builder.setLogLevel(LogLevel::None);
+        builder.setDistanceFieldThreadCount(1);
+
+        std::uint64_t roomsPlaced{ 0 };
+        std::chrono::duration<double> totalTime{};
+
+        for (auto _ : state)
+        {
+            const LabyrinthResult& result{ builder.build() };
+            std::chrono::duration<double> phase{ result.stats.*phaseTime };
+
+            state.SetIterationTime(phase.count());
+            totalTime += phase;
+            roomsPlaced += result.rooms.size();
+        }
+
+        state.counters["us_per_room"] = std::chrono::duration<double, std::micro>{ totalTime }.count() / static_cast<double>(roomsPlaced);
+    }
+
+    // Phase sizes. Phases can take a small share of a build, and manual time only counts the phase,
+    // so grids of 16384 x 16384 cells build once rather than until the phase adds up to the minimum time.
+    // Those are far larger than the caches, to compare grid layouts.
+    void applyPhaseArgs(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({ "size", "rooms" })->Args({ 256, 64 })->Args({ 1024, 128 })->Args({ 4096, 128 })
+            ->UseManualTime()->Unit(benchmark::kMillisecond);
+    }
+
+    void applyLargePhaseArgs(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({ "size", "rooms" })->Args({ 16384, 128 })->Iterations(1)
+            ->UseManualTime()->Unit(benchmark::kMillisecond);
+    }
+
+    // recalculateDistanceField() after every room.
+    BENCHMARK_CAPTURE(BM_BuildPhase, distance_field, &LabyrinthStats::distanceFieldTime)->Apply(applyPhaseArgs);
+    BENCHMARK_CAPTURE(BM_BuildPhase, distance_field, &LabyrinthStats::distanceFieldTime)->Apply(applyLargePhaseArgs);
+
+    // Casting search rays for a free footprint.
+    BENCHMARK_CAPTURE(BM_BuildPhase, spawn_search, &LabyrinthStats::spawnSearchTime)->Apply(applyPhaseArgs);
+    BENCHMARK_CAPTURE(BM_BuildPhase, spawn_search, &LabyrinthStats::spawnSearchTime)->Apply(applyLargePhaseArgs);
+
+    // Carving each new room's hallway down the distance field, the bulk of connectToExistingRooms().
+    BENCHMARK_CAPTURE(BM_BuildPhase, hallway_carve, &LabyrinthStats::hallwayCarveTime)->Apply(applyPhaseArgs);
+    BENCHMARK_CAPTURE(BM_BuildPhase, hallway_carve, &LabyrinthStats::hallwayCarveTime)->Apply(applyLargePhaseArgs);
+
+    // Propagate a whole distance field from scratch, over the cells of a built labyrinth.
+    // Arguments: grid side in cells, engine (0 breadth first search, 1 raster sweeps).
+    void BM_DistanceEngine(benchmark::State& state)
+    {
+        int size{ static_cast<int>(state.range(0)) };
+        bool isRaster{ state.range(1) != 0 };
+
+        LabyrinthBuilder builder{ VectorIntXY{ size, size }, 128, CELL_UNIT, makeRoom(6), 1u };
+        builder.setLogLevel(LogLevel::None);
+        builder.setDistanceFieldThreadCount(1);
+        const DistanceField& built{ builder.build().distanceField };
+
+        DistanceField unpropagated{ built.getDimensions() };
+        std::vector<VectorIntXY> seeds{};
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                VectorIntXY cell{ x, y };
+                CellKind kind{ built.getKind(cell) };
+                if (kind != CellKind::Open)
+                {
+                    unpropagated.setKind(cell, kind);
+                }
+
+                if (kind == CellKind::Hall || kind == CellKind::PotentialDoor)
+                {
+                    seeds.push_back(cell);
+                }
+            }
+        }
+
+        DistanceField field{};
+        std::uint64_t cellsVisited{ 0 };
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            field = unpropagated;
+            state.ResumeTiming();
+
+            cellsVisited += isRaster ? field.propagateRaster() : field.propagate(seeds, 0);
+        }
+
+        if (!(field == built))
+        {
+            state.SkipWithError("The propagated distance field differs from the built one.");
+        }
+
+        std::int64_t cellCount{ std::int64_t{ size } * size };
+        state.counters["cells_per_second"] = benchmark::Counter(static_cast<double>(cellCount * state.iterations()), benchmark::Counter::kIsRate);
+        state.counters["visited_per_cell"] = static_cast<double>(cellsVisited) / static_cast<double>(cellCount * state.iterations());
+    }
+
+    BENCHMARK(BM_DistanceEngine)
+        ->ArgNames({ "size", "raster" })
+        ->ArgsProduct({ { 256, 1024, 4096 }, { 0, 1 } })
+        ->Unit(benchmark::kMillisecond);
+
+    // Placement on crowded grids, evaluating one or several attempts at a time. Argument: placement candidates per batch.
+    void BM_CrowdedPlacement(benchmark::State& state)
+    {
+        const unsigned int seedCount{ 10 };
+
+        std::vector<LabyrinthBuilder> builders{};
+        for (unsigned int seed = 0; seed < seedCount; seed++)
+        {
+            LabyrinthBuilder& builder{ builders.emplace_back(VectorIntXY{ 96, 96 }, 300, CELL_UNIT, makeRoom(6), seed) };
+            builder.setLogLevel(LogLevel::None);
+            builder.setDistanceFieldThreadCount(0);
+            builder.setPlacementCandidateCount(static_cast<std::size_t>(state.range(0)));
+        }
+
+        PlacementCounters totals{};
+
+        for (auto _ : state)
+        {
+            for (LabyrinthBuilder& builder : builders)
+            {
+                builder.build();
+
+                const PlacementCounters& counters{ builder.getPlacementCounters() };
+                totals.roomsPlaced += counters.roomsPlaced;
+                totals.failedAttempts += counters.failedAttempts;
+                totals.discardedAttempts += counters.discardedAttempts;
+            }
+        }
+
+        state.counters["rooms_per_second"] = benchmark::Counter(static_cast<double>(totals.roomsPlaced), benchmark::Counter::kIsRate);
+        state.counters["failed_per_room"] = static_cast<double>(totals.failedAttempts) / static_cast<double>(totals.roomsPlaced);
+        state.counters["discarded_per_room"] = static_cast<double>(totals.discardedAttempts) / static_cast<double>(totals.roomsPlaced);
+    }
+
+    BENCHMARK(BM_CrowdedPlacement)->ArgName("candidates")->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+    // Levels of 128 x 128 cells with 40 rooms each, generated together. Argument: threads.
+    void BM_BatchGenerator(benchmark::State& state)
+    {
+        const int jobCount{ 64 };
+
+        std::vector<BatchJob> jobs{};
+        for (int i = 0; i < jobCount; i++)
+        {
+            jobs.push_back(BatchJob{ VectorIntXY{ 128, 128 }, 40, CELL_UNIT, { RoomType{ makeRoom(6) } }, BatchGenerator::deriveJobSeed(1, static_cast<std::size_t>(i)) });
+        }
+
+        BatchGenerator generator{ static_cast<std::size_t>(state.range(0)) };
+
+        for (auto _ : state)
+        {
+            std::vector<LabyrinthResult> results{ generator.generate(jobs) };
+            benchmark::DoNotOptimize(results.data());
+        }
+
+        state.counters["levels_per_second"] = benchmark::Counter(static_cast<double>(jobCount * state.iterations()), benchmark::Counter::kIsRate);
+    }
+
+    BENCHMARK(BM_BatchGenerator)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+    // A strip of 250 x 250 cell chunks streamed out of a 100,000 x 100,000 cell world. Argument: threads.
+    void BM_ChunkedGeneratorStream(benchmark::State& state)
+    {
+        const VectorIntXY chunkCounts{ 400, 400 };
+
+        std::vector<VectorIntXY> chunks{};
+        for (int x = 0; x < 100; x++)
+        {
+            chunks.push_back(VectorIntXY{ x, 0 });
+        }
+
+        ChunkedGenerator generator{ chunkCounts, VectorIntXY{ 250, 250 }, 30, CELL_UNIT, { RoomType{ makeRoom(6) } }, 1u, 1, static_cast<std::size_t>(state.range(0)) };
+
+        for (auto _ : state)
+        {
+            std::atomic<std::size_t> hallwayCellCount{ 0 };
+            generator.streamChunks(chunks, [&hallwayCellCount](VectorIntXY, const LabyrinthResult& result)
+                {
+                    hallwayCellCount += result.hallwayCells.size();
+                });
+            benchmark::DoNotOptimize(hallwayCellCount.load());
+        }
+
+        state.counters["chunks_per_second"] = benchmark::Counter(static_cast<double>(chunks.size() * state.iterations()), benchmark::Counter::kIsRate);
+    }
+
+    BENCHMARK(BM_ChunkedGeneratorStream)->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+    // Map a saved labyrinth and decode every row, the alternative to generating it again with BM_Build.
+    // Argument: grid side in cells.
+    void BM_LabyrinthFileLoad(benchmark::State& state)
+    {
+        int size{ static_cast<int>(state.range(0)) };
+        std::filesystem::path path{ std::filesystem::temp_directory_path() / "LabyrinthGenerationBenchmark.laby" };
+
+        {
+            LabyrinthBuilder builder{ VectorIntXY{ size, size }, size / 8, CELL_UNIT, makeRoom(6), 1u };
+            builder.setLogLevel(LogLevel::None);
+            saveLabyrinth(builder.build(), path.string());
+        }
+
+        std::vector<CellKind> row(static_cast<std::size_t>(size));
+
+        for (auto _ : state)
+        {
+            MappedLabyrinth mapped{ path.string() };
+            const LabyrinthView& view{ mapped.getView() };
+
+            std::size_t hallCells{ 0 };
+            for (int y = 0; y < size; y++)
+            {
+                view.decodeRow(y, row.data());
+                hallCells += static_cast<std::size_t>(std::count(row.begin(), row.end(), CellKind::Hall));
+            }
+            benchmark::DoNotOptimize(hallCells);
+        }
+
+        state.counters["file_bytes"] = static_cast<double>(std::filesystem::file_size(path));
+        std::filesystem::remove(path);
+    }
+
+    BENCHMARK(BM_LabyrinthFileLoad)->ArgName("size")->Arg(256)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+    // One room search direction: two doubles in [-1, 1).
+    void BM_RandomDirection_StandardLibrary(benchmark::State& state)
+    {
+        std::default_random_engine engine{ 1u };
+        std::uniform_real_distribution<double> distribution{ -1.0, 1.0 };
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(distribution(engine) + distribution(engine));
+        }
+    }
+
+    BENCHMARK(BM_RandomDirection_StandardLibrary);
+
+    void BM_RandomDirection_Xoshiro256StarStar(benchmark::State& state)
+    {
+        Xoshiro256StarStar engine{ 1u };
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(randomDouble(engine, -1.0, 1.0) + randomDouble(engine, -1.0, 1.0));
+        }
+    }
+
+    BENCHMARK(BM_RandomDirection_Xoshiro256StarStar);
+
+    // Search rays from the center to the edge of a 1024 x 1024 grid.
+    const VectorIntXY RAY_GRID_DIMENSIONS{ 1024, 1024 };
+
+    std::vector<VectorXY> makeRayDirections()
+    {
+        std::vector<VectorXY> directions{};
+        Xoshiro256StarStar random{ 1u };
+        for (int i = 0; i < 1000; i++)
+        {
+            directions.push_back(VectorXY{ randomDouble(random, -1.0, 1.0), randomDouble(random, -1.0, 1.0) });
+        }
+        return directions;
+    }
+
+    bool isInRayGrid(VectorIntXY cell)
+    {
+        return cell.x >= 0 && cell.y >= 0 && cell.x < RAY_GRID_DIMENSIONS.x && cell.y < RAY_GRID_DIMENSIONS.y;
+    }
+
+    void BM_SearchPath_Legacy(benchmark::State& state)
+    {
+        std::vector<VectorXY> directions{ makeRayDirections() };
+        CellUnitConverter converter{ CELL_UNIT };
+        VectorIntXY center{ RAY_GRID_DIMENSIONS.x / 2, RAY_GRID_DIMENSIONS.y / 2 };
+        std::int64_t cellCount{ 0 };
+
+        for (auto _ : state)
+        {
+            for (VectorXY direction : directions)
+            {
+                VectorXY position{ converter.cellToMeters(center.x), converter.cellToMeters(center.y) };
+                for (VectorIntXY cell{ center }; isInRayGrid(cell); cellCount++)
+                {
+                    position = legacyNextCoordinateAlongSearchPath(position, direction, CELL_UNIT);
+                    cell = VectorIntXY{ converter.metersToCellFloor(position.x), converter.metersToCellFloor(position.y) };
+                }
+            }
+        }
+
+        state.counters["cells_per_second"] = benchmark::Counter(static_cast<double>(cellCount), benchmark::Counter::kIsRate);
+    }
+
+    BENCHMARK(BM_SearchPath_Legacy)->Unit(benchmark::kMillisecond);
+
+    void BM_SearchPath_GridRay(benchmark::State& state)
+    {
+        std::vector<VectorXY> directions{ makeRayDirections() };
+        VectorIntXY center{ RAY_GRID_DIMENSIONS.x / 2, RAY_GRID_DIMENSIONS.y / 2 };
+        std::int64_t cellCount{ 0 };
+
+        for (auto _ : state)
+        {
+            for (VectorXY direction : directions)
+            {
+                for (GridRay ray{ center, direction }; isInRayGrid(ray.getCell()); ray.step())
+                {
+                    cellCount++;
+                }
+            }
+        }
+
+        state.counters["cells_per_second"] = benchmark::Counter(static_cast<double>(cellCount), benchmark::Counter::kIsRate);
+    }
+
+    BENCHMARK(BM_SearchPath_GridRay)->Unit(benchmark::kMillisecond);
+
+    // Stamp a room, then test footprints at random positions, as placement alternates between the two.
+    // Argument: footprint side in cells. Runs until the grid is a quarter blocked, then starts over.
+    const VectorIntXY FOOTPRINT_GRID_DIMENSIONS{ 4096, 4096 };
+    const int FOOTPRINT_TESTS_PER_ROOM{ 64 };
+
+    template <typename Occupancy, typename IsOpen>
+    void runFootprintBenchmark(benchmark::State& state, IsOpen isOpen)
+    {
+        int side{ static_cast<int>(state.range(0)) };
+        std::uniform_int_distribution<int> randomX{ 0, FOOTPRINT_GRID_DIMENSIONS.x - side };
+        std::uniform_int_distribution<int> randomY{ 0, FOOTPRINT_GRID_DIMENSIONS.y - side };
+        std::int64_t roomLimit{ (std::int64_t{ FOOTPRINT_GRID_DIMENSIONS.x } * FOOTPRINT_GRID_DIMENSIONS.y) / (4 * side * side) };
+
+        Occupancy occupancy{ FOOTPRINT_GRID_DIMENSIONS };
+        Xoshiro256StarStar random{ 1u };
+        std::int64_t roomCount{ 0 };
+        std::int64_t openCount{ 0 };
+
+        for (auto _ : state)
+        {
+            if (roomCount++ == roomLimit)
+            {
+                occupancy.clear();
+                roomCount = 0;
+            }
+
+            occupancy.setBlocked(VectorIntXY{ randomX(random), randomY(random) }, VectorIntXY{ side, side });
+
+            for (int i = 0; i < FOOTPRINT_TESTS_PER_ROOM; i++)
+            {
+                openCount += isOpen(occupancy, VectorIntXY{ randomX(random), randomY(random) }, VectorIntXY{ side, side });
+            }
+        }
+
+        benchmark::DoNotOptimize(openCount);
+        state.counters["tests_per_second"] = benchmark::Counter(static_cast<double>(FOOTPRINT_TESTS_PER_ROOM * state.iterations()), benchmark::Counter::kIsRate);
+    }
+
+    void BM_Footprint_SummedAreaTable(benchmark::State& state)
+    {
+        runFootprintBenchmark<SummedAreaTable>(state, [](SummedAreaTable& table, VectorIntXY min, VectorIntXY size)
+            {
+                return table.countBlocked(min, size) == 0;
+            });
+    }
+
+    BENCHMARK(BM_Footprint_SummedAreaTable)->ArgName("side")->Arg(4)->Arg(16)->Arg(64)->Arg(256);
+
+    void BM_Footprint_Bitboard(benchmark::State& state)
+    {
+        runFootprintBenchmark<OccupancyBitboard>(state, [](const OccupancyBitboard& board, VectorIntXY min, VectorIntXY size)
+            {
+                return board.isRectangleOpen(min, size);
+            });
+    }
+
+    BENCHMARK(BM_Footprint_Bitboard)->ArgName("side")->Arg(4)->Arg(16)->Arg(64)->Arg(256);
+}
+
+BENCHMARK_MAIN();
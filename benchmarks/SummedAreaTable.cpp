@@ -0,0 +1,77 @@
+#include "SummedAreaTable.h"
+
+namespace LabyrinthGeneration
+{
+    SummedAreaTable::SummedAreaTable(VectorIntXY dimensions) :
+        m_blocked{ dimensions, 0, 0 },
+        m_sums{ dimensions, 0, 0 }
+    {
+    }
+
+    void SummedAreaTable::clear()
+    {
+        m_blocked.fill(0);
+        m_sums.fill(0);
+        m_isDirty = false;
+    }
+
+    void SummedAreaTable::setBlocked(VectorIntXY min, VectorIntXY size)
+    {
+        if (size.x < 1 || size.y < 1) { return; }
+
+        for (int y = min.y; y < min.y + size.y; y++)
+        {
+            for (int x = min.x; x < min.x + size.x; x++)
+            {
+                m_blocked(x, y) = 1;
+            }
+        }
+
+        markDirty(min);
+    }
+
+    std::uint32_t SummedAreaTable::countBlocked(VectorIntXY min, VectorIntXY size)
+    {
+        refresh();
+
+        VectorIntXY max{ min.x + size.x - 1, min.y + size.y - 1 };
+
+        return m_sums(max.x, max.y)
+            - m_sums(min.x - 1, max.y)
+            - m_sums(max.x, min.y - 1)
+            + m_sums(min.x - 1, min.y - 1);
+    }
+
+    void SummedAreaTable::markDirty(VectorIntXY cell)
+    {
+        if (!m_isDirty)
+        {
+            m_dirtyMin = cell;
+            m_isDirty = true;
+            return;
+        }
+
+        if (cell.x < m_dirtyMin.x) { m_dirtyMin.x = cell.x; }
+        if (cell.y < m_dirtyMin.y) { m_dirtyMin.y = cell.y; }
+    }
+
+    void SummedAreaTable::refresh()
+    {
+        if (!m_isDirty)
+        {
+            return;
+        }
+
+        // Sums above or left of the dirty corner do not include any changed cell.
+        VectorIntXY dimensions{ m_sums.getDimensions() };
+        for (int y = m_dirtyMin.y; y < dimensions.y; y++)
+        {
+            for (int x = m_dirtyMin.x; x < dimensions.x; x++)
+            {
+                m_sums(x, y) = m_blocked(x, y) + m_sums(x - 1, y) + m_sums(x, y - 1) - m_sums(x - 1, y - 1);
+            }
+        }
+
+        m_isDirty = false;
+    }
+}
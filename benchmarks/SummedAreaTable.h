@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Grid.h"
+#include "VectorIntXY.h"
+
+#include <cstdint>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Summed-area table (integral image) of blocked cells, the footprint test LabyrinthBuilder used before
+    /// OccupancyBitboard. Only built into the benchmarks, to compare the two.
+    ///
+    /// Cells can only go from open to blocked. Blocking a cell marks the table dirty from that cell onward,
+    /// and the next query refreshes only the part of the table that depends on the changed cells.
+    /// Any rectangle can then be tested for blocked cells in constant time.
+    /// </summary>
+    class SummedAreaTable
+    {
+        Grid<std::uint8_t> m_blocked;
+
+        // m_sums(x, y) holds the number of blocked cells in the rectangle from (0, 0) to (x, y) inclusive.
+        // The border holds zero, so rectangles touching the edge need no special cases.
+        // Sums wrap around on overflow, which keeps rectangle counts exact up to 2^32 - 1 cells.
+        Grid<std::uint32_t> m_sums;
+
+        // Minimum corner of the cells blocked since the last refresh.
+        VectorIntXY m_dirtyMin{};
+        bool m_isDirty{ false };
+
+    public:
+        SummedAreaTable(VectorIntXY dimensions);
+
+        /// <summary>
+        /// Mark every cell as open.
+        /// </summary>
+        void clear();
+
+        /// <summary>
+        /// Block every cell of the rectangle with the given minimum corner and size.
+        /// </summary>
+        void setBlocked(VectorIntXY min, VectorIntXY size);
+
+        /// <summary>
+        /// Number of blocked cells in the rectangle with the given minimum corner and size.
+        /// The rectangle must lie within the grid.
+        /// </summary>
+        std::uint32_t countBlocked(VectorIntXY min, VectorIntXY size);
+
+    private:
+        void markDirty(VectorIntXY cell);
+
+        // Bring the sums up to date with every blocked cell.
+        void refresh();
+    };
+}
@@ -0,0 +1,147 @@
+#include "AliasTable.h"
+
+#include "SelfTest.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace LabyrinthGeneration
+{
+    AliasTable::AliasTable(const std::vector<double>& weights)
+    {
+        rebuild(weights);
+    }
+
+    void AliasTable::rebuild(const std::vector<double>& weights)
+    {
+        double totalWeight{ 0 };
+        std::size_t firstPositive{ weights.size() };
+
+        for (std::size_t i = 0; i < weights.size(); i++)
+        {
+            if (weights[i] < 0)
+            {
+                throw std::runtime_error{ "AliasTable weights cannot be negative!" };
+            }
+
+            if (weights[i] > 0 && firstPositive == weights.size())
+            {
+                firstPositive = i;
+            }
+
+            totalWeight += weights[i];
+        }
+
+        m_probabilities.clear();
+        m_aliases.clear();
+
+        if (totalWeight <= 0)
+        {
+            return;
+        }
+
+        // Scale weights so they average to one, then pair each entry below one
+        // with an entry above one that fills the rest of its column.
+        std::size_t count{ weights.size() };
+        m_probabilities.resize(count);
+        m_aliases.resize(count);
+        m_scaledWeights.resize(count);
+        m_small.clear();
+        m_large.clear();
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            m_scaledWeights[i] = weights[i] * count / totalWeight;
+            if (m_scaledWeights[i] < 1.0)
+            {
+                m_small.push_back(i);
+            }
+            else
+            {
+                m_large.push_back(i);
+            }
+        }
+
+        while (!m_small.empty() && !m_large.empty())
+        {
+            std::size_t small{ m_small.back() };
+            m_small.pop_back();
+            std::size_t large{ m_large.back() };
+
+            m_probabilities[small] = m_scaledWeights[small];
+            m_aliases[small] = large;
+
+            m_scaledWeights[large] = (m_scaledWeights[large] + m_scaledWeights[small]) - 1.0;
+            if (m_scaledWeights[large] < 1.0)
+            {
+                m_large.pop_back();
+                m_small.push_back(large);
+            }
+        }
+
+        // Whatever is left is within rounding error of one.
+        // Entries with no weight are redirected so they can never be picked.
+        for (std::vector<std::size_t>* leftovers : { &m_large, &m_small })
+        {
+            for (std::size_t i : *leftovers)
+            {
+                bool hasWeight{ weights[i] > 0 };
+                m_probabilities[i] = hasWeight ? 1.0 : 0.0;
+                m_aliases[i] = hasWeight ? i : firstPositive;
+            }
+        }
+    }
+
+    bool AliasTable::isEmpty() const
+    {
+        return m_probabilities.empty();
+    }
+
+    std::size_t AliasTable::size() const
+    {
+        return m_probabilities.size();
+    }
+
+    void runAliasTableTests()
+    {
+        AliasTable table{ std::vector<double>{ 1, 0, 3, 6 } };
+        LABYRINTH_CHECK(!table.isEmpty());
+        LABYRINTH_CHECK(4 == table.size());
+
+        // Sample frequencies follow the weights, and zero weights are never picked.
+        Xoshiro256StarStar randomEngine{ 42 };
+        const int sampleCount{ 100000 };
+        std::vector<int> counts(4, 0);
+        for (int i = 0; i < sampleCount; i++)
+        {
+            counts[table.sample(randomEngine)]++;
+        }
+
+        LABYRINTH_CHECK(0 == counts[1]);
+        LABYRINTH_CHECK(std::abs((counts[0] / static_cast<double>(sampleCount)) - 0.1) < 0.01);
+        LABYRINTH_CHECK(std::abs((counts[2] / static_cast<double>(sampleCount)) - 0.3) < 0.01);
+        LABYRINTH_CHECK(std::abs((counts[3] / static_cast<double>(sampleCount)) - 0.6) < 0.01);
+
+        // A single weighted entry is always picked.
+        table.rebuild(std::vector<double>{ 0, 0, 5 });
+        for (int i = 0; i < 100; i++)
+        {
+            LABYRINTH_CHECK(2 == table.sample(randomEngine));
+        }
+
+        // No weight at all gives an empty table.
+        table.rebuild(std::vector<double>{ 0, 0 });
+        LABYRINTH_CHECK(table.isEmpty());
+
+        bool caught{ false };
+        try
+        {
+            table.rebuild(std::vector<double>{ 1, -1 });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        LABYRINTH_CHECK(caught);
+    }
+}
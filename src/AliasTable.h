@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Random.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Walker's alias table for picking an index with probability proportional to its weight.
+    ///
+    /// Building the table takes linear time. Every sample afterwards takes constant time,
+    /// no matter how many entries the table has.
+    /// </summary>
+    class AliasTable
+    {
+        std::vector<double> m_probabilities{};
+        std::vector<std::size_t> m_aliases{};
+
+        // Scratch storage for building, kept so rebuilding does not allocate.
+        std::vector<double> m_scaledWeights{};
+        std::vector<std::size_t> m_small{};
+        std::vector<std::size_t> m_large{};
+
+    public:
+        AliasTable() = default;
+        explicit AliasTable(const std::vector<double>& weights);
+
+        /// <summary>
+        /// Replace the weights. Weights must not be negative. Entries with a weight of zero are never picked.
+        /// If every weight is zero the table is empty.
+        /// </summary>
+        void rebuild(const std::vector<double>& weights);
+
+        bool isEmpty() const;
+
+        std::size_t size() const;
+
+        /// <summary>
+        /// Pick an index. The table must not be empty.
+        /// </summary>
+        template <typename Engine>
+        std::size_t sample(Engine& engine) const
+        {
+            std::size_t index{ static_cast<std::size_t>(randomIndex(engine, m_probabilities.size())) };
+            return randomUnitDouble(engine) < m_probabilities[index] ? index : m_aliases[index];
+        }
+    };
+
+    void runAliasTableTests();
+}
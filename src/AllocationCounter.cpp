@@ -0,0 +1,35 @@
+#include "AllocationCounter.h"
+
+#include "SelfTest.h"
+
+#include <memory>
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        thread_local std::uint64_t threadAllocationCount{ 0 };
+    }
+
+    std::uint64_t getThreadAllocationCount()
+    {
+        return threadAllocationCount;
+    }
+
+    void recordThreadAllocation()
+    {
+        threadAllocationCount++;
+    }
+
+    void runAllocationCounterTests()
+    {
+        // Needs the operator new in AllocationHooks.cpp, which every executable running the self tests links.
+        std::uint64_t before{ getThreadAllocationCount() };
+        std::unique_ptr<int> allocated{ std::make_unique<int>(3) };
+        LABYRINTH_CHECK(before + 1 == getThreadAllocationCount());
+
+        int onStack{ 4 };
+        LABYRINTH_CHECK(before + 1 == getThreadAllocationCount());
+        LABYRINTH_CHECK(*allocated + onStack == 7);
+    }
+}
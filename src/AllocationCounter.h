@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Number of heap allocations the calling thread has made through the global operator new.
+    ///
+    /// The count only moves in executables that link AllocationHooks.cpp, which replaces the global operator new
+    /// and delete. The library itself never replaces them, so programs using it keep their own allocator.
+    /// Compare two readings to check that a piece of code does not allocate.
+    /// </summary>
+    std::uint64_t getThreadAllocationCount();
+
+    /// <summary>
+    /// Count one allocation by the calling thread. Called by the operator new in AllocationHooks.cpp.
+    /// </summary>
+    void recordThreadAllocation();
+
+    void runAllocationCounterTests();
+}
@@ -0,0 +1,47 @@
+// Replaces the global operator new and delete to count allocations for getThreadAllocationCount().
+// Only linked into our own executables, never into the library.
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t size)
+{
+    LabyrinthGeneration::recordThreadAllocation();
+
+    // malloc(0) may return null, but operator new must return a unique pointer.
+    if (size == 0) { size = 1; }
+
+    if (void* memory = std::malloc(size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
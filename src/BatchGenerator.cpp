@@ -0,0 +1,81 @@
+#include "BatchGenerator.h"
+
+#include "Random.h"
+#include "SelfTest.h"
+
+
+namespace LabyrinthGeneration
+{
+    BatchGenerator::BatchGenerator(std::size_t threadCount) :
+        m_workerPool{ threadCount }
+    {
+    }
+
+    std::size_t BatchGenerator::getThreadCount() const
+    {
+        return m_workerPool.getThreadCount();
+    }
+
+    std::uint64_t BatchGenerator::deriveJobSeed(std::uint64_t masterSeed, std::size_t jobIndex)
+    {
+        return deriveSeed(masterSeed, jobIndex);
+    }
+
+    std::vector<LabyrinthResult> BatchGenerator::generate(const std::vector<BatchJob>& jobs)
+    {
+        std::vector<LabyrinthResult> results(jobs.size());
+
+        m_workerPool.parallelFor(jobs.size(), [&](std::size_t index, std::size_t)
+            {
+                const BatchJob& job{ jobs[index] };
+
+                LabyrinthBuilder builder{
+                    job.labyrinthDimensions,
+                    job.numRoomsToSpawn,
+                    job.cellUnit,
+                    job.roomTypes,
+                    job.randomSeed };
+
+                builder.setLogLevel(LogLevel::None);
+                results[index] = builder.build();
+            });
+
+        return results;
+    }
+
+    void runBatchGeneratorTests()
+    {
+        Room room
+        {
+            Vector3{6, 6, 3},
+            {
+                PlaneTransform{ Vector3{3, 0, 0}, VectorXY{0, -1} },
+                PlaneTransform{ Vector3{3, 6, 0}, VectorXY{0, 1} },
+                PlaneTransform{ Vector3{0, 3, 0}, VectorXY{-1, 0} },
+                PlaneTransform{ Vector3{6, 3, 0}, VectorXY{1, 0} },
+            }
+        };
+
+        std::vector<BatchJob> jobs{};
+        for (unsigned int i = 0; i < 12; i++)
+        {
+            jobs.push_back(BatchJob{ VectorIntXY{ 30 + static_cast<int>(i), 40 }, 6, 2.0, { RoomType{ room } }, BatchGenerator::deriveJobSeed(100, i) });
+        }
+
+        BatchGenerator generator{ 4 };
+        std::vector<LabyrinthResult> results{ generator.generate(jobs) };
+        LABYRINTH_CHECK(results.size() == jobs.size());
+
+        // Results come back in submission order and match building each job serially.
+        for (std::size_t i = 0; i < jobs.size(); i++)
+        {
+            LabyrinthBuilder builder{ jobs[i].labyrinthDimensions, jobs[i].numRoomsToSpawn, jobs[i].cellUnit, jobs[i].roomTypes, jobs[i].randomSeed };
+            builder.setLogLevel(LogLevel::None);
+
+            LABYRINTH_CHECK(results[i] == builder.build());
+
+            // Job seeds keep all 64 bits through the build.
+            LABYRINTH_CHECK(deriveSeed(100, i) == results[i].randomSeed);
+        }
+    }
+}
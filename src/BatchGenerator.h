@@ -0,0 +1,57 @@
+#pragma once
+
+#include "LabyrinthBuilder.h"
+#include "LabyrinthResult.h"
+#include "VectorIntXY.h"
+#include "WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Everything needed to generate one labyrinth.
+    /// </summary>
+    struct BatchJob
+    {
+        VectorIntXY labyrinthDimensions;
+        int numRoomsToSpawn;
+        double cellUnit;
+        std::vector<RoomType> roomTypes;
+        std::uint64_t randomSeed;
+    };
+
+    /// <summary>
+    /// Generates many labyrinths in parallel on a fixed pool of worker threads.
+    ///
+    /// Every job is built by its own LabyrinthBuilder seeded with the job's seed,
+    /// so each result is identical to building that job on its own.
+    /// </summary>
+    class BatchGenerator
+    {
+        WorkerPool m_workerPool;
+
+    public:
+        /// <summary>
+        /// Zero uses one worker per hardware thread.
+        /// </summary>
+        explicit BatchGenerator(std::size_t threadCount = 0);
+
+        std::size_t getThreadCount() const;
+
+        /// <summary>
+        /// Seed for job number jobIndex of a batch generated from one master seed.
+        /// Each job gets an independent stream, however many jobs there are and whichever thread builds them.
+        /// </summary>
+        static std::uint64_t deriveJobSeed(std::uint64_t masterSeed, std::size_t jobIndex);
+
+        /// <summary>
+        /// Build every job and return the results in submission order.
+        /// </summary>
+        std::vector<LabyrinthResult> generate(const std::vector<BatchJob>& jobs);
+    };
+
+    void runBatchGeneratorTests();
+}
@@ -1,21 +1,22 @@
 #include "CellUnitConverter.h"
 
-#include <cassert>
+#include "SelfTest.h"
+
 #include <cmath>
 
 namespace LabyrinthGeneration
 {
-    int CellUnitConverter::metersToCellRound(double meters)
+    int CellUnitConverter::metersToCellRound(double meters) const
     {
         return static_cast<int>(std::round(meters / m_metersPerCellUnit));
     }
 
-    int CellUnitConverter::metersToCellFloor(double meters)
+    int CellUnitConverter::metersToCellFloor(double meters) const
     {
         return static_cast<int>(std::floor(meters / m_metersPerCellUnit));
     }
 
-    double CellUnitConverter::cellToMeters(int cellCoordinateComponent)
+    double CellUnitConverter::cellToMeters(int cellCoordinateComponent) const
     {
         return cellCoordinateComponent * m_metersPerCellUnit;
     }
@@ -24,8 +25,8 @@ namespace LabyrinthGeneration
     {
         CellUnitConverter converter{ 2.5 };
 
-        assert(5 == converter.metersToCellRound(12));
-        assert(4 == converter.metersToCellFloor(12));
-        assert(7.5 == converter.cellToMeters(3));
+        LABYRINTH_CHECK(5 == converter.metersToCellRound(12));
+        LABYRINTH_CHECK(4 == converter.metersToCellFloor(12));
+        LABYRINTH_CHECK(7.5 == converter.cellToMeters(3));
     }
 }
\ No newline at end of file
@@ -12,11 +12,11 @@ namespace LabyrinthGeneration
     public:
         CellUnitConverter(double metersPerCellUnit) : m_metersPerCellUnit{ metersPerCellUnit } {}
 
-        int metersToCellRound(double meters);
+        int metersToCellRound(double meters) const;
 
-        int metersToCellFloor(double meters);
+        int metersToCellFloor(double meters) const;
 
-        double cellToMeters(int cellCoordinateComponent);
+        double cellToMeters(int cellCoordinateComponent) const;
     };
 
     void runCellUnitConverterTests();
@@ -0,0 +1,307 @@
+#include "ChunkedGenerator.h"
+
+#include "Random.h"
+#include "SelfTest.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        // What each hash of a chunk coordinate is used for.
+        enum class ChunkHashPurpose : std::uint64_t
+        {
+            EastDoor,
+            SouthDoor
+        };
+
+        // Neighbouring inputs give unrelated outputs.
+        std::uint64_t mixBits(std::uint64_t value)
+        {
+            return SplitMix64{ value }.next();
+        }
+
+        std::uint64_t getChunkKey(VectorIntXY chunk)
+        {
+            return (std::uint64_t{ static_cast<std::uint32_t>(chunk.x) } << 32) | static_cast<std::uint32_t>(chunk.y);
+        }
+
+        std::uint64_t hashChunk(std::uint64_t worldSeed, VectorIntXY chunk, ChunkHashPurpose purpose)
+        {
+            return mixBits(mixBits(mixBits(worldSeed) ^ getChunkKey(chunk)) ^ static_cast<std::uint64_t>(purpose));
+        }
+
+        // Doors stay off the corners so a corner cell is never shared by two doors.
+        int getDoorPosition(std::uint64_t worldSeed, VectorIntXY chunk, ChunkHashPurpose purpose, int edgeLength)
+        {
+            return 1 + static_cast<int>(hashChunk(worldSeed, chunk, purpose) % static_cast<std::uint64_t>(edgeLength - 2));
+        }
+    }
+
+    ChunkedGenerator::ChunkedGenerator(
+        VectorIntXY chunkCounts,
+        VectorIntXY chunkDimensions,
+        int roomsPerChunk,
+        double cellUnit,
+        std::vector<RoomType> roomTypes,
+        std::uint64_t worldSeed,
+        std::size_t cacheCapacity,
+        std::size_t threadCount) :
+        m_chunkCounts{ chunkCounts },
+        m_chunkDimensions{ chunkDimensions },
+        m_roomsPerChunk{ roomsPerChunk },
+        m_cellUnit{ cellUnit },
+        m_roomTypes{ std::move(roomTypes) },
+        m_worldSeed{ worldSeed },
+        m_cacheCapacity{ cacheCapacity },
+        m_workerPool{ threadCount }
+    {
+        if (chunkCounts.x < 1 || chunkCounts.y < 1)
+        {
+            throw std::runtime_error{ "ChunkedGenerator needs at least one chunk along each axis!" };
+        }
+
+        if (chunkDimensions.x < 3 || chunkDimensions.y < 3)
+        {
+            throw std::runtime_error{ "ChunkedGenerator chunks must be at least 3 x 3 cells!" };
+        }
+
+        if (cacheCapacity < 1)
+        {
+            throw std::runtime_error{ "ChunkedGenerator cache must hold at least one chunk!" };
+        }
+
+        m_workers.resize(m_workerPool.getThreadCount());
+    }
+
+    const VectorIntXY& ChunkedGenerator::getChunkCounts() const
+    {
+        return m_chunkCounts;
+    }
+
+    const VectorIntXY& ChunkedGenerator::getChunkDimensions() const
+    {
+        return m_chunkDimensions;
+    }
+
+    bool ChunkedGenerator::isChunkInBounds(VectorIntXY chunk) const
+    {
+        return chunk.x >= 0 && chunk.y >= 0 && chunk.x < m_chunkCounts.x && chunk.y < m_chunkCounts.y;
+    }
+
+    VectorIntXY ChunkedGenerator::getChunkOrigin(VectorIntXY chunk) const
+    {
+        return VectorIntXY{ chunk.x * m_chunkDimensions.x, chunk.y * m_chunkDimensions.y };
+    }
+
+    std::uint64_t ChunkedGenerator::getChunkSeed(VectorIntXY chunk) const
+    {
+        return deriveSeed(m_worldSeed, getChunkKey(chunk));
+    }
+
+    void ChunkedGenerator::getBoundaryDoorCells(VectorIntXY chunk, std::vector<VectorIntXY>& cells) const
+    {
+        cells.clear();
+
+        // Each edge's door belongs to the chunk west or north of it, so both chunks that share the edge agree on it.
+        if (chunk.x + 1 < m_chunkCounts.x)
+        {
+            cells.push_back(VectorIntXY{ m_chunkDimensions.x - 1, getDoorPosition(m_worldSeed, chunk, ChunkHashPurpose::EastDoor, m_chunkDimensions.y) });
+        }
+
+        if (chunk.x > 0)
+        {
+            cells.push_back(VectorIntXY{ 0, getDoorPosition(m_worldSeed, chunk - VectorIntXY{ 1, 0 }, ChunkHashPurpose::EastDoor, m_chunkDimensions.y) });
+        }
+
+        if (chunk.y + 1 < m_chunkCounts.y)
+        {
+            cells.push_back(VectorIntXY{ getDoorPosition(m_worldSeed, chunk, ChunkHashPurpose::SouthDoor, m_chunkDimensions.x), m_chunkDimensions.y - 1 });
+        }
+
+        if (chunk.y > 0)
+        {
+            cells.push_back(VectorIntXY{ getDoorPosition(m_worldSeed, chunk - VectorIntXY{ 0, 1 }, ChunkHashPurpose::SouthDoor, m_chunkDimensions.x), 0 });
+        }
+    }
+
+    const LabyrinthResult& ChunkedGenerator::getChunk(VectorIntXY chunk)
+    {
+        checkChunkInBounds(chunk);
+
+        auto cached{ m_cacheIndex.find(getChunkKey(chunk)) };
+        if (cached != m_cacheIndex.end())
+        {
+            m_cache.splice(m_cache.begin(), m_cache, cached->second);
+            return cached->second->second;
+        }
+
+        const LabyrinthResult& result{ buildChunk(m_cacheWorker, chunk) };
+
+        if (m_cache.size() < m_cacheCapacity)
+        {
+            m_cache.emplace_front(chunk, result);
+        }
+        else
+        {
+            // Evict the least recently used chunk and reuse its storage.
+            m_cache.splice(m_cache.begin(), m_cache, std::prev(m_cache.end()));
+            m_cacheIndex.erase(getChunkKey(m_cache.front().first));
+
+            m_cache.front().first = chunk;
+            m_cache.front().second = result;
+        }
+
+        m_cacheIndex[getChunkKey(chunk)] = m_cache.begin();
+        return m_cache.front().second;
+    }
+
+    bool ChunkedGenerator::isChunkCached(VectorIntXY chunk) const
+    {
+        return m_cacheIndex.contains(getChunkKey(chunk));
+    }
+
+    std::size_t ChunkedGenerator::getCachedChunkCount() const
+    {
+        return m_cache.size();
+    }
+
+    void ChunkedGenerator::streamChunks(const std::vector<VectorIntXY>& chunks, const ChunkSink& sink)
+    {
+        for (VectorIntXY chunk : chunks)
+        {
+            checkChunkInBounds(chunk);
+        }
+
+        m_workerPool.parallelFor(chunks.size(), [&](std::size_t index, std::size_t workerIndex)
+            {
+                sink(chunks[index], buildChunk(m_workers[workerIndex], chunks[index]));
+            });
+    }
+
+    const LabyrinthResult& ChunkedGenerator::buildChunk(ChunkWorker& worker, VectorIntXY chunk) const
+    {
+        if (!worker.builder)
+        {
+            worker.builder = std::make_unique<LabyrinthBuilder>(m_chunkDimensions, m_roomsPerChunk, m_cellUnit, m_roomTypes);
+
+            // Chunks already run in parallel with each other.
+            worker.builder->setDistanceFieldThreadCount(1);
+        }
+
+        getBoundaryDoorCells(chunk, worker.boundaryDoorCells);
+
+        worker.builder->setRandomSeed(getChunkSeed(chunk));
+        worker.builder->setBoundaryDoorCells(worker.boundaryDoorCells);
+
+        return worker.builder->build();
+    }
+
+    void ChunkedGenerator::checkChunkInBounds(VectorIntXY chunk) const
+    {
+        if (!isChunkInBounds(chunk))
+        {
+            throw std::runtime_error{ "ChunkedGenerator chunk " + chunk.toString() + " is outside the world!" };
+        }
+    }
+
+    void runChunkedGeneratorTests()
+    {
+        Room room
+        {
+            Vector3{6, 6, 3},
+            {
+                PlaneTransform{ Vector3{3, 0, 0}, VectorXY{0, -1} },
+                PlaneTransform{ Vector3{3, 6, 0}, VectorXY{0, 1} },
+                PlaneTransform{ Vector3{0, 3, 0}, VectorXY{-1, 0} },
+                PlaneTransform{ Vector3{6, 3, 0}, VectorXY{1, 0} },
+            }
+        };
+
+        ChunkedGenerator generator{ VectorIntXY{ 3, 3 }, VectorIntXY{ 40, 32 }, 5, 2.0, { RoomType{ room } }, 42u, 2, 4 };
+        LABYRINTH_CHECK(VectorIntXY(80, 32) == generator.getChunkOrigin(VectorIntXY{ 2, 1 }));
+
+        // Every boundary door is carved as a hallway, and the chunk across the edge has its door on the neighbouring cell.
+        std::vector<VectorIntXY> doors{};
+        std::vector<VectorIntXY> neighbourDoors{};
+        std::map<std::pair<int, int>, LabyrinthResult> chunks{};
+
+        for (int y = 0; y < 3; y++)
+        {
+            for (int x = 0; x < 3; x++)
+            {
+                VectorIntXY chunk{ x, y };
+                LabyrinthResult result{ generator.getChunk(chunk) };
+                LABYRINTH_CHECK(BuildStatus::BoundaryDoorUnreachable != result.status);
+
+                generator.getBoundaryDoorCells(chunk, doors);
+                LABYRINTH_CHECK(doors.size() == static_cast<std::size_t>((x > 0) + (x < 2) + (y > 0) + (y < 2)));
+
+                for (VectorIntXY door : doors)
+                {
+                    LABYRINTH_CHECK(CellKind::Hall == result.distanceField.getKind(door));
+                }
+
+                if (x < 2)
+                {
+                    generator.getBoundaryDoorCells(VectorIntXY{ x + 1, y }, neighbourDoors);
+                    VectorIntXY eastDoor{ doors.front() };
+                    LABYRINTH_CHECK(std::find(neighbourDoors.begin(), neighbourDoors.end(), VectorIntXY{ 0, eastDoor.y }) != neighbourDoors.end());
+                }
+
+                chunks.emplace(std::make_pair(x, y), std::move(result));
+            }
+        }
+
+        // The cache holds the two most recently used chunks.
+        LABYRINTH_CHECK(2 == generator.getCachedChunkCount());
+        LABYRINTH_CHECK(generator.isChunkCached(VectorIntXY{ 2, 2 }));
+        LABYRINTH_CHECK(generator.isChunkCached(VectorIntXY{ 1, 2 }));
+        generator.getChunk(VectorIntXY{ 1, 2 });
+        generator.getChunk(VectorIntXY{ 0, 0 });
+        LABYRINTH_CHECK(generator.isChunkCached(VectorIntXY{ 1, 2 }));
+        LABYRINTH_CHECK(!generator.isChunkCached(VectorIntXY{ 2, 2 }));
+        LABYRINTH_CHECK(chunks.at({ 0, 0 }) == generator.getChunk(VectorIntXY{ 0, 0 }));
+
+        // Streaming in parallel gives the same chunks, and a generator with the same seed gives the same world.
+        ChunkedGenerator sameWorld{ VectorIntXY{ 3, 3 }, VectorIntXY{ 40, 32 }, 5, 2.0, { RoomType{ room } }, 42u, 1, 4 };
+
+        std::vector<VectorIntXY> everyChunk{};
+        for (int y = 0; y < 3; y++)
+        {
+            for (int x = 0; x < 3; x++)
+            {
+                everyChunk.push_back(VectorIntXY{ x, y });
+            }
+        }
+
+        std::mutex streamedMutex{};
+        std::size_t streamedCount{ 0 };
+        sameWorld.streamChunks(everyChunk, [&](VectorIntXY chunk, const LabyrinthResult& result)
+            {
+                bool isSame{ chunks.at({ chunk.x, chunk.y }) == result };
+
+                std::lock_guard<std::mutex> lock{ streamedMutex };
+                LABYRINTH_CHECK(isSame);
+                streamedCount++;
+            });
+        LABYRINTH_CHECK(9 == streamedCount);
+        LABYRINTH_CHECK(0 == sameWorld.getCachedChunkCount());
+
+        bool caught{ false };
+        try
+        {
+            generator.getChunk(VectorIntXY{ 3, 0 });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        LABYRINTH_CHECK(caught);
+    }
+}
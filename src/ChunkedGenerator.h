@@ -0,0 +1,117 @@
+#pragma once
+
+#include "LabyrinthBuilder.h"
+#include "LabyrinthResult.h"
+#include "VectorIntXY.h"
+#include "WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Generates a labyrinth too large to hold in memory as a grid of fixed size chunks.
+    ///
+    /// Each chunk is an independent labyrinth with its own rooms and hallways, built from a seed derived
+    /// from the world seed and the chunk's coordinate. Neighbouring chunks are joined by one door cell
+    /// on each shared edge. Its position is derived from the world seed too, so both chunks agree on it
+    /// without either being generated first, and any chunk can be generated on its own, in any order.
+    ///
+    /// Chunk results use chunk local cell coordinates. Add getChunkOrigin() for world coordinates.
+    /// A chunk that could not reach one of its boundary doors has BuildStatus::BoundaryDoorUnreachable,
+    /// and its neighbour across that edge is not joined to it.
+    /// </summary>
+    class ChunkedGenerator
+    {
+    public:
+        using ChunkSink = std::function<void(VectorIntXY chunk, const LabyrinthResult& result)>;
+
+    private:
+        VectorIntXY m_chunkCounts;
+        VectorIntXY m_chunkDimensions;
+        int m_roomsPerChunk;
+        double m_cellUnit;
+        std::vector<RoomType> m_roomTypes;
+        std::uint64_t m_worldSeed;
+
+        // Least recently used chunks are evicted once the cache holds this many.
+        std::size_t m_cacheCapacity;
+
+        // Most recently used first.
+        std::list<std::pair<VectorIntXY, LabyrinthResult>> m_cache{};
+        std::unordered_map<std::uint64_t, std::list<std::pair<VectorIntXY, LabyrinthResult>>::iterator> m_cacheIndex{};
+
+        // A builder and its scratch storage, reused for every chunk it builds.
+        struct ChunkWorker
+        {
+            std::unique_ptr<LabyrinthBuilder> builder{};
+            std::vector<VectorIntXY> boundaryDoorCells{};
+        };
+
+        // Builds chunks for getChunk().
+        ChunkWorker m_cacheWorker{};
+
+        // One per pool worker for streamChunks(). Builders are created the first time a worker needs one.
+        WorkerPool m_workerPool;
+        std::vector<ChunkWorker> m_workers{};
+
+    public:
+        /// <summary>
+        /// Zero threads uses one worker per hardware thread.
+        /// </summary>
+        ChunkedGenerator(
+            VectorIntXY chunkCounts,
+            VectorIntXY chunkDimensions,
+            int roomsPerChunk,
+            double cellUnit,
+            std::vector<RoomType> roomTypes,
+            std::uint64_t worldSeed,
+            std::size_t cacheCapacity = 16,
+            std::size_t threadCount = 0);
+
+        const VectorIntXY& getChunkCounts() const;
+        const VectorIntXY& getChunkDimensions() const;
+
+        bool isChunkInBounds(VectorIntXY chunk) const;
+
+        /// <summary>
+        /// World cell coordinate of the chunk's minimum corner.
+        /// </summary>
+        VectorIntXY getChunkOrigin(VectorIntXY chunk) const;
+
+        std::uint64_t getChunkSeed(VectorIntXY chunk) const;
+
+        /// <summary>
+        /// The chunk's door cells on edges shared with other chunks, in chunk local coordinates.
+        /// </summary>
+        void getBoundaryDoorCells(VectorIntXY chunk, std::vector<VectorIntXY>& cells) const;
+
+        /// <summary>
+        /// Generate the chunk, or return it from the cache. The reference stays valid until the chunk is evicted.
+        /// </summary>
+        const LabyrinthResult& getChunk(VectorIntXY chunk);
+
+        bool isChunkCached(VectorIntXY chunk) const;
+        std::size_t getCachedChunkCount() const;
+
+        /// <summary>
+        /// Generate the given chunks in parallel and hand each one to the sink as soon as it is built.
+        /// Nothing is kept afterwards, so memory stays bounded by the number of workers.
+        /// The sink is called from worker threads, possibly at the same time, and the result is only valid during the call.
+        /// </summary>
+        void streamChunks(const std::vector<VectorIntXY>& chunks, const ChunkSink& sink);
+
+    private:
+        const LabyrinthResult& buildChunk(ChunkWorker& worker, VectorIntXY chunk) const;
+        void checkChunkInBounds(VectorIntXY chunk) const;
+    };
+
+    void runChunkedGeneratorTests();
+}
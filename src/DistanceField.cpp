@@ -0,0 +1,793 @@
+#include "DistanceField.h"
+
+#include "SelfTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+
+#if defined(_MSC_VER)
+#define LABYRINTH_RASTER_NOINLINE __declspec(noinline)
+#else
+#define LABYRINTH_RASTER_NOINLINE __attribute__((noinline))
+#endif
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        const VectorIntXY TRAVERSAL_DIRECTIONS[]{ {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+
+        // Frontier cells handed to a worker at a time during parallel propagation.
+        const std::size_t CELLS_PER_TASK{ 256 };
+
+        // Rows relaxed at once by the raster sweeps along x. Sixteen 16 bit values fill a 256 bit vector.
+        constexpr int RASTER_BAND_ROWS{ 16 };
+
+        // Stored values of the kinds that are not open. An open cell stores its distance plus HALL_VALUE,
+        // so a distance of one is the first value above them.
+        constexpr std::uint32_t ROOM_VALUE{ 0 };
+        constexpr std::uint32_t POTENTIAL_DOOR_VALUE{ 1 };
+        constexpr std::uint32_t HALL_VALUE{ 2 };
+
+        template <typename Value>
+        constexpr Value UNCALCULATED_VALUE{ std::numeric_limits<Value>::max() };
+
+        template <typename Value>
+        Value encodeKind(CellKind kind)
+        {
+            switch (kind)
+            {
+            case CellKind::Room:
+                return ROOM_VALUE;
+            case CellKind::PotentialDoor:
+                return POTENTIAL_DOOR_VALUE;
+            case CellKind::Hall:
+                return HALL_VALUE;
+            default:
+                return UNCALCULATED_VALUE<Value>;
+            }
+        }
+
+        template <typename Value>
+        CellKind decodeKind(Value value)
+        {
+            switch (value)
+            {
+            case ROOM_VALUE:
+                return CellKind::Room;
+            case POTENTIAL_DOOR_VALUE:
+                return CellKind::PotentialDoor;
+            case HALL_VALUE:
+                return CellKind::Hall;
+            default:
+                return CellKind::Open;
+            }
+        }
+
+        template <typename Value>
+        std::uint32_t decodeDistance(Value value)
+        {
+            if (value <= HALL_VALUE)
+            {
+                return 0;
+            }
+
+            // Widen the uncalculated value of the compact plane to the public one.
+            return value == UNCALCULATED_VALUE<Value> ? DistanceField::UNCALCULATED : value - HALL_VALUE;
+        }
+
+        /// <summary>
+        /// Lower a cell to one past a neighbour's distance, unless the neighbour is a room. Rooms and the border
+        /// are walls, while hallways and potential doors are sources at distance zero. Every candidate is above
+        /// the values of the kinds that are not open, so only open cells are ever lowered. Returns the bits that changed.
+        ///
+        /// Branch free and without widening, so loops of it can use the full vector width. The comparisons are
+        /// spelled out because GCC does not vectorize std::max on these values. A neighbour one short of uncalculated
+        /// would give a distance too large to store, which sets overflow.
+        /// </summary>
+        template <typename Value>
+        Value relaxRaster(Value& value, Value neighbourValue, Value& overflow)
+        {
+            const Value uncalculated{ UNCALCULATED_VALUE<Value> };
+
+            Value current{ value };
+            Value atLeastHall{ neighbourValue > HALL_VALUE ? neighbourValue : static_cast<Value>(HALL_VALUE) };
+            Value source{ neighbourValue == ROOM_VALUE ? uncalculated : atLeastHall };
+            Value candidate{ static_cast<Value>(source + (source != uncalculated)) };
+            Value lowered{ current < candidate ? current : candidate };
+
+            overflow |= static_cast<Value>((source == uncalculated - 1) & (current == uncalculated));
+            value = lowered;
+            return static_cast<Value>(lowered ^ current);
+        }
+
+        /// <summary>
+        /// Relax one column of a band from the neighbouring column, every row at once. Returns the bits that changed.
+        ///
+        /// Kept out of line: inlined into the loop over columns, GCC unrolls the rows before it vectorizes them
+        /// and then gives up on the unrolled copy.
+        /// </summary>
+        template <typename Value>
+        LABYRINTH_RASTER_NOINLINE Value relaxRasterBand(Value* column, const Value* neighbourColumn, Value& overflow)
+        {
+            // Local accumulators, so the compiler need not assume they overlap the band.
+            Value changed{ 0 };
+            Value columnOverflow{ 0 };
+            for (int row = 0; row < RASTER_BAND_ROWS; row++)
+            {
+                changed |= relaxRaster(column[row], neighbourColumn[row], columnOverflow);
+            }
+
+            overflow |= columnOverflow;
+            return changed;
+        }
+    }
+
+    DistanceField::DistanceField(VectorIntXY dimensions) :
+        m_dimensions{ dimensions }
+    {
+        clear();
+    }
+
+    void DistanceField::clear()
+    {
+        m_rasterDirtyMin = VectorIntXY{ std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+        m_rasterDirtyMax = VectorIntXY{ -1, -1 };
+
+        m_isCompact = !m_isWideForced;
+        if (m_isCompact)
+        {
+            m_compactValues.reset(m_dimensions, UNCALCULATED_VALUE<std::uint16_t>, ROOM_VALUE);
+        }
+        else
+        {
+            m_wideValues.reset(m_dimensions, UNCALCULATED, ROOM_VALUE);
+        }
+    }
+
+
+    void DistanceField::setWideDistancesForced(bool isForced)
+    {
+        m_isWideForced = isForced;
+    }
+
+    const VectorIntXY& DistanceField::getDimensions() const
+    {
+        return m_dimensions;
+    }
+
+    bool DistanceField::isInBounds(VectorIntXY cell) const
+    {
+        return cell.x >= 0 && cell.y >= 0 && cell.x < m_dimensions.x && cell.y < m_dimensions.y;
+    }
+
+    bool DistanceField::isCompact() const
+    {
+        return m_isCompact;
+    }
+
+    CellKind DistanceField::getKind(VectorIntXY cell) const
+    {
+        if (m_isCompact)
+        {
+            return decodeKind(m_compactValues[cell]);
+        }
+
+        return decodeKind(m_wideValues[cell]);
+    }
+
+    std::uint32_t DistanceField::getDistance(VectorIntXY cell) const
+    {
+        if (m_isCompact)
+        {
+            return decodeDistance(m_compactValues[cell]);
+        }
+
+        return decodeDistance(m_wideValues[cell]);
+    }
+
+    void DistanceField::setKind(VectorIntXY cell, CellKind kind)
+    {
+        if (kind != CellKind::Room)
+        {
+            m_rasterDirtyMin = VectorIntXY{ std::min(m_rasterDirtyMin.x, cell.x), std::min(m_rasterDirtyMin.y, cell.y) };
+            m_rasterDirtyMax = VectorIntXY{ std::max(m_rasterDirtyMax.x, cell.x), std::max(m_rasterDirtyMax.y, cell.y) };
+        }
+
+        if (m_isCompact)
+        {
+            m_compactValues[cell] = encodeKind<std::uint16_t>(kind);
+        }
+        else
+        {
+            m_wideValues[cell] = encodeKind<std::uint32_t>(kind);
+        }
+    }
+
+    void DistanceField::setKind(VectorIntXY min, VectorIntXY size, CellKind kind)
+    {
+        for (int y = min.y; y < min.y + size.y; y++)
+        {
+            for (int x = min.x; x < min.x + size.x; x++)
+            {
+                setKind(VectorIntXY{ x, y }, kind);
+            }
+        }
+    }
+
+    std::size_t DistanceField::getMemoryUsage() const
+    {
+        return m_isCompact
+            ? m_compactValues.storageSize() * sizeof(std::uint16_t)
+            : m_wideValues.storageSize() * sizeof(std::uint32_t);
+    }
+
+    std::size_t DistanceField::propagate(const std::vector<VectorIntXY>& seeds, std::size_t firstSeed)
+    {
+        // The queue is a vector read from the front, so its storage is reused by every propagation.
+        m_queue.assign(seeds.begin() + firstSeed, seeds.end());
+        std::size_t front{ 0 };
+
+        if (m_isCompact && propagateQueue(m_compactValues, front))
+        {
+            return m_queue.size();
+        }
+
+        // Either the plane was already wide or a distance did not fit in 16 bits.
+        // The queue still holds the unfinished part of the search, so carry on with 32 bits.
+        if (m_isCompact)
+        {
+            widen();
+        }
+
+        propagateQueue(m_wideValues, front);
+        return m_queue.size();
+    }
+
+    template <typename Value>
+    bool DistanceField::propagateQueue(Grid<Value>& values, std::size_t& front)
+    {
+        // The largest value is reserved for uncalculated cells.
+        const std::uint32_t maximumValue{ UNCALCULATED_VALUE<Value> - 1u };
+
+        for (; front < m_queue.size(); front++)
+        {
+            VectorIntXY currentCoordinate{ m_queue[front] };
+
+            // Hallways and potential doors are at distance zero, whatever their stored value.
+            std::uint32_t nextValue{ std::max<std::uint32_t>(values[currentCoordinate], HALL_VALUE) + 1u };
+
+            if (nextValue > maximumValue)
+            {
+                return false;
+            }
+
+            // Rooms, hallways, potential doors and the border store values below any distance, so they are never lowered.
+            for (VectorIntXY direction : TRAVERSAL_DIRECTIONS)
+            {
+                VectorIntXY cellToCheck{ currentCoordinate + direction };
+                Value& cellToCheckValue{ values[cellToCheck] };
+
+                if (cellToCheckValue > nextValue)
+                {
+                    cellToCheckValue = static_cast<Value>(nextValue);
+                    m_queue.push_back(cellToCheck);
+                }
+            }
+        }
+
+        return true;
+    }
+
+    std::size_t DistanceField::propagateParallel(const std::vector<VectorIntXY>& seeds, std::size_t firstSeed, WorkerPool& workerPool)
+    {
+        // Level-synchronous BFS. Every cell in the frontier has the distance of the current level,
+        // so each neighbor is lowered to level + 1 with an atomic compare-exchange.
+        // Only the worker whose exchange succeeds adds the neighbor to its next frontier.
+        // Values are only ever lowered to the level being expanded, so the result matches the serial BFS.
+        m_nextFrontiers.resize(workerPool.getThreadCount());
+        m_frontier.assign(seeds.begin() + firstSeed, seeds.end());
+
+        std::uint32_t nextDistance{ 1 };
+        std::size_t visitedCount{ 0 };
+
+        while (!m_frontier.empty())
+        {
+            visitedCount += m_frontier.size();
+
+            if (m_isCompact && nextDistance + HALL_VALUE >= UNCALCULATED_VALUE<std::uint16_t>)
+            {
+                widen();
+            }
+
+            if (m_isCompact)
+            {
+                expandFrontier(m_compactValues, nextDistance, workerPool);
+            }
+            else
+            {
+                expandFrontier(m_wideValues, nextDistance, workerPool);
+            }
+
+            m_frontier.clear();
+            for (std::vector<VectorIntXY>& nextFrontier : m_nextFrontiers)
+            {
+                m_frontier.insert(m_frontier.end(), nextFrontier.begin(), nextFrontier.end());
+                nextFrontier.clear();
+            }
+
+            nextDistance++;
+        }
+
+        return visitedCount;
+    }
+
+    template <typename Value>
+    void DistanceField::expandFrontier(Grid<Value>& values, std::uint32_t nextDistance, WorkerPool& workerPool)
+    {
+        const Value newValue{ static_cast<Value>(nextDistance + HALL_VALUE) };
+
+        auto expand = [&](std::size_t task, std::size_t workerIndex)
+            {
+                std::vector<VectorIntXY>& nextFrontier{ m_nextFrontiers[workerIndex] };
+                std::size_t begin{ task * CELLS_PER_TASK };
+                std::size_t end{ std::min(begin + CELLS_PER_TASK, m_frontier.size()) };
+
+                for (std::size_t i = begin; i < end; i++)
+                {
+                    for (VectorIntXY direction : TRAVERSAL_DIRECTIONS)
+                    {
+                        VectorIntXY cellToCheck{ m_frontier[i] + direction };
+                        std::atomic_ref<Value> cellToCheckValue{ values[cellToCheck] };
+
+                        Value currentValue{ cellToCheckValue.load(std::memory_order_relaxed) };
+                        while (currentValue > newValue)
+                        {
+                            if (cellToCheckValue.compare_exchange_weak(currentValue, newValue, std::memory_order_relaxed))
+                            {
+                                nextFrontier.push_back(cellToCheck);
+                                break;
+                            }
+                        }
+                    }
+                }
+            };
+
+        std::size_t taskCount{ (m_frontier.size() + CELLS_PER_TASK - 1) / CELLS_PER_TASK };
+        if (taskCount == 1)
+        {
+            // Not worth waking the workers for a small frontier.
+            expand(0, 0);
+        }
+        else
+        {
+            workerPool.parallelFor(taskCount, expand);
+        }
+    }
+
+    std::size_t DistanceField::recalculate()
+    {
+        std::vector<VectorIntXY> seeds{};
+        for (int y = 0; y < m_dimensions.y; y++)
+        {
+            for (int x = 0; x < m_dimensions.x; x++)
+            {
+                VectorIntXY cell{ x, y };
+                CellKind kind{ getKind(cell) };
+                if (kind == CellKind::Open)
+                {
+                    setKind(cell, kind);
+                }
+                else if (kind != CellKind::Room)
+                {
+                    seeds.push_back(cell);
+                }
+            }
+        }
+
+        std::size_t visitedCount{ propagate(seeds, 0) };
+
+        // Every distance is settled, so the raster sweeps have nothing left to do.
+        m_rasterDirtyMin = VectorIntXY{ std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+        m_rasterDirtyMax = VectorIntXY{ -1, -1 };
+        return visitedCount;
+    }
+
+    std::size_t DistanceField::propagateRaster()
+    {
+        if (m_rasterDirtyMax.x < m_rasterDirtyMin.x || m_rasterDirtyMax.y < m_rasterDirtyMin.y)
+        {
+            return 0;
+        }
+
+        // Cells next to a changed cell are the only ones the first sweep can lower.
+        VectorIntXY min{ std::max(m_rasterDirtyMin.x - 1, 0), std::max(m_rasterDirtyMin.y - 1, 0) };
+        VectorIntXY max{ std::min(m_rasterDirtyMax.x + 1, m_dimensions.x - 1), std::min(m_rasterDirtyMax.y + 1, m_dimensions.y - 1) };
+
+        m_rasterDirtyMin = VectorIntXY{ std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+        m_rasterDirtyMax = VectorIntXY{ -1, -1 };
+
+        std::size_t sweptCount{ 0 };
+        if (m_isCompact)
+        {
+            if (settleRaster(m_compactValues, m_compactRasterScratch, min, max, sweptCount))
+            {
+                return sweptCount;
+            }
+
+            // A distance did not fit in 16 bits. Every stored distance is still an upper bound, so carry on with 32 bits,
+            // sweeping the whole grid since the cells left unlowered could be anywhere the sweeps reached.
+            widen();
+            min = VectorIntXY{ 0, 0 };
+            max = VectorIntXY{ m_dimensions.x - 1, m_dimensions.y - 1 };
+        }
+
+        settleRaster(m_wideValues, m_wideRasterScratch, min, max, sweptCount);
+        return sweptCount;
+    }
+
+    template <typename Value>
+    bool DistanceField::settleRaster(Grid<Value>& values, RasterScratch<Value>& scratch, VectorIntXY min, VectorIntXY max, std::size_t& sweptCount)
+    {
+        VectorIntXY changedMin{};
+        VectorIntXY changedMax{};
+        bool isOverflowing{ false };
+
+        while (true)
+        {
+            bool isChanged{ sweepRaster(values, scratch, min, max, changedMin, changedMax, isOverflowing) };
+            sweptCount += static_cast<std::size_t>(max.x - min.x + 1) * static_cast<std::size_t>(max.y - min.y + 1);
+
+            if (isOverflowing)
+            {
+                return false;
+            }
+
+            if (!isChanged)
+            {
+                return true;
+            }
+
+            // Only the neighbours of changed cells can be lowered next, but lowered distances tend to spread
+            // much further than one cell a sweep.
+            int margin{ std::max(changedMax.x - changedMin.x, changedMax.y - changedMin.y) + 1 };
+            min = VectorIntXY{ std::max(changedMin.x - margin, 0), std::max(changedMin.y - margin, 0) };
+            max = VectorIntXY{ std::min(changedMax.x + margin, m_dimensions.x - 1), std::min(changedMax.y + margin, m_dimensions.y - 1) };
+        }
+    }
+
+    template <typename Value>
+    bool DistanceField::sweepRaster(
+        Grid<Value>& values,
+        RasterScratch<Value>& scratch,
+        VectorIntXY min,
+        VectorIntXY max,
+        VectorIntXY& changedMin,
+        VectorIntXY& changedMax,
+        bool& isOverflowing)
+    {
+        const int width{ max.x - min.x + 1 };
+
+        scratch.band.resize(static_cast<std::size_t>(width + 2) * RASTER_BAND_ROWS);
+        scratch.columnChanges.assign(static_cast<std::size_t>(width), 0);
+        Value* band{ scratch.band.data() };
+        Value* columnChanges{ scratch.columnChanges.data() };
+
+        int firstChangedRow{ max.y + 1 };
+        int lastChangedRow{ min.y - 1 };
+        Value overflowing{ 0 };
+
+        auto markRowChanged = [&](int y)
+            {
+                firstChangedRow = std::min(firstChangedRow, y);
+                lastChangedRow = std::max(lastChangedRow, y);
+            };
+
+        // Every cell of the row depends only on the neighbouring row.
+        auto sweepRowFrom = [&](int y, int neighbourY)
+            {
+                Value changed{ 0 };
+                Value overflow{ 0 };
+
+                for (int x = 0; x < width; x++)
+                {
+                    Value change{ relaxRaster(values(min.x + x, y), values(min.x + x, neighbourY), overflow) };
+                    columnChanges[x] |= change;
+                    changed |= change;
+                }
+
+                overflowing |= overflow;
+                if (changed != 0)
+                {
+                    markRowChanged(y);
+                }
+            };
+
+        // Copy the band, with a column of neighbours on each side, so that its rows run down each column.
+        // Rows past the end of the rectangle are rooms, which neither change nor lower anything.
+        auto sweepBandAlongRows = [&](int firstY, int rowCount)
+            {
+                if (rowCount < RASTER_BAND_ROWS)
+                {
+                    std::fill(band, band + ((width + 2) * RASTER_BAND_ROWS), static_cast<Value>(ROOM_VALUE));
+                }
+
+                for (int row = 0; row < rowCount; row++)
+                {
+                    for (int x = -1; x <= width; x++)
+                    {
+                        band[((x + 1) * RASTER_BAND_ROWS) + row] = values(min.x + x, firstY + row);
+                    }
+                }
+
+                Value overflow{ 0 };
+
+                for (int x = 0; x < width; x++)
+                {
+                    Value* column{ band + ((x + 1) * RASTER_BAND_ROWS) };
+                    columnChanges[x] |= relaxRasterBand(column, column - RASTER_BAND_ROWS, overflow);
+                }
+
+                for (int x = width - 1; x >= 0; x--)
+                {
+                    Value* column{ band + ((x + 1) * RASTER_BAND_ROWS) };
+                    columnChanges[x] |= relaxRasterBand(column, column + RASTER_BAND_ROWS, overflow);
+                }
+
+                // Which rows changed comes from the copy back, which keeps it out of the loops above.
+                Value rowChanges[RASTER_BAND_ROWS]{};
+                for (int x = 0; x < width; x++)
+                {
+                    const Value* column{ band + ((x + 1) * RASTER_BAND_ROWS) };
+                    for (int row = 0; row < rowCount; row++)
+                    {
+                        Value& value{ values(min.x + x, firstY + row) };
+                        rowChanges[row] |= static_cast<Value>(value ^ column[row]);
+                        value = column[row];
+                    }
+                }
+
+                overflowing |= overflow;
+                for (int row = 0; row < rowCount; row++)
+                {
+                    if (rowChanges[row] != 0)
+                    {
+                        markRowChanged(firstY + row);
+                    }
+                }
+            };
+
+        // The border around the grid is made of rooms, so it never lowers anything.
+        for (int firstY = min.y; firstY <= max.y; firstY += RASTER_BAND_ROWS)
+        {
+            int rowCount{ std::min(RASTER_BAND_ROWS, max.y - firstY + 1) };
+            for (int y = firstY; y < firstY + rowCount; y++)
+            {
+                sweepRowFrom(y, y - 1);
+            }
+
+            sweepBandAlongRows(firstY, rowCount);
+        }
+
+        int lastBandY{ min.y + (((max.y - min.y) / RASTER_BAND_ROWS) * RASTER_BAND_ROWS) };
+        for (int firstY = lastBandY; firstY >= min.y; firstY -= RASTER_BAND_ROWS)
+        {
+            int rowCount{ std::min(RASTER_BAND_ROWS, max.y - firstY + 1) };
+            for (int y = firstY + rowCount - 1; y >= firstY; y--)
+            {
+                sweepRowFrom(y, y + 1);
+            }
+
+            sweepBandAlongRows(firstY, rowCount);
+        }
+
+        isOverflowing = overflowing != 0;
+        if (firstChangedRow > lastChangedRow)
+        {
+            return false;
+        }
+
+        int firstChangedColumn{ 0 };
+        while (columnChanges[firstChangedColumn] == 0) { firstChangedColumn++; }
+
+        int lastChangedColumn{ width - 1 };
+        while (columnChanges[lastChangedColumn] == 0) { lastChangedColumn--; }
+
+        changedMin = VectorIntXY{ min.x + firstChangedColumn, firstChangedRow };
+        changedMax = VectorIntXY{ min.x + lastChangedColumn, lastChangedRow };
+        return true;
+    }
+
+    void DistanceField::widen()
+    {
+        m_wideValues.reset(m_dimensions, UNCALCULATED, ROOM_VALUE);
+
+        // Kinds and distances keep their values, only the uncalculated value moves.
+        for (int y = 0; y < m_dimensions.y; y++)
+        {
+            for (int x = 0; x < m_dimensions.x; x++)
+            {
+                std::uint16_t value{ m_compactValues(x, y) };
+                m_wideValues(x, y) = value == UNCALCULATED_VALUE<std::uint16_t> ? UNCALCULATED : value;
+            }
+        }
+
+        m_isCompact = false;
+    }
+
+    bool operator==(const DistanceField& left, const DistanceField& right)
+    {
+        if (left.getDimensions() != right.getDimensions())
+        {
+            return false;
+        }
+
+        for (int y = 0; y < left.getDimensions().y; y++)
+        {
+            for (int x = 0; x < left.getDimensions().x; x++)
+            {
+                VectorIntXY cell{ x, y };
+                if (left.getKind(cell) != right.getKind(cell) || left.getDistance(cell) != right.getDistance(cell))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void runDistanceFieldTests()
+    {
+        DistanceField field{ VectorIntXY{ 5, 4 } };
+        LABYRINTH_CHECK(field.isCompact());
+        LABYRINTH_CHECK(CellKind::Open == field.getKind(VectorIntXY{ 0, 0 }));
+        LABYRINTH_CHECK(DistanceField::UNCALCULATED == field.getDistance(VectorIntXY{ 0, 0 }));
+
+        // A room wall splits the field. Distances go around it.
+        field.setKind(VectorIntXY{ 2, 0 }, VectorIntXY{ 1, 3 }, CellKind::Room);
+        field.setKind(VectorIntXY{ 0, 0 }, CellKind::Hall);
+
+        std::vector<VectorIntXY> seeds{ VectorIntXY{ 0, 0 } };
+        field.propagate(seeds, 0);
+
+        LABYRINTH_CHECK(0 == field.getDistance(VectorIntXY{ 0, 0 }));
+        LABYRINTH_CHECK(1 == field.getDistance(VectorIntXY{ 1, 0 }));
+        LABYRINTH_CHECK(0 == field.getDistance(VectorIntXY{ 2, 0 }));
+        LABYRINTH_CHECK(5 == field.getDistance(VectorIntXY{ 2, 3 }));
+        LABYRINTH_CHECK(8 == field.getDistance(VectorIntXY{ 3, 1 }));
+        LABYRINTH_CHECK(CellKind::Room == field.getKind(VectorIntXY{ 2, 1 }));
+
+        // A new potential door only lowers distances near it.
+        field.setKind(VectorIntXY{ 4, 0 }, CellKind::PotentialDoor);
+        seeds.push_back(VectorIntXY{ 4, 0 });
+        field.propagate(seeds, 1);
+
+        LABYRINTH_CHECK(2 == field.getDistance(VectorIntXY{ 3, 1 }));
+        LABYRINTH_CHECK(5 == field.getDistance(VectorIntXY{ 2, 3 }));
+        LABYRINTH_CHECK(1 == field.getDistance(VectorIntXY{ 1, 0 }));
+
+        // Parallel propagation gives the same field.
+        DistanceField parallelField{ VectorIntXY{ 5, 4 } };
+        parallelField.setKind(VectorIntXY{ 2, 0 }, VectorIntXY{ 1, 3 }, CellKind::Room);
+        parallelField.setKind(VectorIntXY{ 0, 0 }, CellKind::Hall);
+        parallelField.setKind(VectorIntXY{ 4, 0 }, CellKind::PotentialDoor);
+
+        WorkerPool workerPool{ 2 };
+        parallelField.propagateParallel(seeds, 0, workerPool);
+        LABYRINTH_CHECK(field == parallelField);
+
+        // Kinds live in the same plane as distances, two bytes per cell while compact and four once wide.
+        DistanceField wideField{ VectorIntXY{ 5, 4 } };
+        wideField.setWideDistancesForced(true);
+        wideField.clear();
+        LABYRINTH_CHECK(!wideField.isCompact());
+        LABYRINTH_CHECK(2 * field.getMemoryUsage() == wideField.getMemoryUsage());
+
+        // A corridor longer than 16 bit distances can describe widens the distance plane on the fly,
+        // both serially and in parallel.
+        const int corridorLength{ 70000 };
+        DistanceField corridor{ VectorIntXY{ corridorLength, 1 } };
+        DistanceField parallelCorridor{ VectorIntXY{ corridorLength, 1 } };
+        corridor.setKind(VectorIntXY{ 0, 0 }, CellKind::Hall);
+        parallelCorridor.setKind(VectorIntXY{ 0, 0 }, CellKind::Hall);
+
+        std::vector<VectorIntXY> corridorSeeds{ VectorIntXY{ 0, 0 } };
+        // Both searches visit every cell of the corridor once.
+        LABYRINTH_CHECK(corridorLength == corridor.propagate(corridorSeeds, 0));
+        LABYRINTH_CHECK(corridorLength == parallelCorridor.propagateParallel(corridorSeeds, 0, workerPool));
+
+        LABYRINTH_CHECK(!corridor.isCompact());
+        LABYRINTH_CHECK(!parallelCorridor.isCompact());
+        LABYRINTH_CHECK(corridorLength - 1 == corridor.getDistance(VectorIntXY{ corridorLength - 1, 0 }));
+        LABYRINTH_CHECK(CellKind::Hall == corridor.getKind(VectorIntXY{ 0, 0 }));
+        LABYRINTH_CHECK(CellKind::Open == corridor.getKind(VectorIntXY{ corridorLength - 1, 0 }));
+        LABYRINTH_CHECK(corridor == parallelCorridor);
+
+        // Changing kinds after widening still gives zero distances and uncalculated open cells.
+        corridor.setKind(VectorIntXY{ 1, 0 }, CellKind::Room);
+        corridor.setKind(VectorIntXY{ 2, 0 }, CellKind::Open);
+        LABYRINTH_CHECK(CellKind::Room == corridor.getKind(VectorIntXY{ 1, 0 }));
+        LABYRINTH_CHECK(0 == corridor.getDistance(VectorIntXY{ 1, 0 }));
+        LABYRINTH_CHECK(DistanceField::UNCALCULATED == corridor.getDistance(VectorIntXY{ 2, 0 }));
+
+        // Clearing goes back to compact distances.
+        corridor.clear();
+        LABYRINTH_CHECK(corridor.isCompact());
+
+        // The raster sweeps widen the same corridor too.
+        DistanceField rasterCorridor{ VectorIntXY{ corridorLength, 1 } };
+        rasterCorridor.setKind(VectorIntXY{ 0, 0 }, CellKind::Hall);
+        rasterCorridor.propagateRaster();
+        LABYRINTH_CHECK(!rasterCorridor.isCompact());
+        LABYRINTH_CHECK(corridorLength - 1 == rasterCorridor.getDistance(VectorIntXY{ corridorLength - 1, 0 }));
+
+        // Raster sweeps match the breadth first search on random room layouts, from scratch and after
+        // adding rooms and hallways to an already propagated field.
+        std::mt19937 random{ 777 };
+
+        for (int layout = 0; layout < 20; layout++)
+        {
+            VectorIntXY dimensions{
+                std::uniform_int_distribution<int>{ 1, 60 }(random),
+                std::uniform_int_distribution<int>{ 1, 60 }(random) };
+            std::uniform_int_distribution<int> randomX{ 0, dimensions.x - 1 };
+            std::uniform_int_distribution<int> randomY{ 0, dimensions.y - 1 };
+
+            DistanceField searched{ dimensions };
+            DistanceField swept{ dimensions };
+            std::vector<VectorIntXY> layoutSeeds{};
+            std::size_t firstSeed{ 0 };
+
+            for (int round = 0; round < 3; round++)
+            {
+                for (int i = 0; i < 12; i++)
+                {
+                    VectorIntXY min{ randomX(random), randomY(random) };
+                    VectorIntXY size{
+                        std::uniform_int_distribution<int>{ 1, std::min(12, dimensions.x - min.x) }(random),
+                        std::uniform_int_distribution<int>{ 1, std::min(12, dimensions.y - min.y) }(random) };
+                    searched.setKind(min, size, CellKind::Room);
+                    swept.setKind(min, size, CellKind::Room);
+                }
+
+                for (int i = 0; i < 3; i++)
+                {
+                    VectorIntXY cell{ randomX(random), randomY(random) };
+                    CellKind kind{ i == 0 ? CellKind::Hall : CellKind::PotentialDoor };
+                    searched.setKind(cell, kind);
+                    swept.setKind(cell, kind);
+                    layoutSeeds.push_back(cell);
+                }
+
+                searched.propagate(layoutSeeds, firstSeed);
+                firstSeed = layoutSeeds.size();
+
+                swept.propagateRaster();
+                LABYRINTH_CHECK(searched == swept);
+            }
+        }
+
+        // Once settled, the sweeps only cover the cells around a change, and nothing at all without one.
+        DistanceField settled{ VectorIntXY{ 200, 150 } };
+        settled.setKind(VectorIntXY{ 20, 30 }, CellKind::Hall);
+        LABYRINTH_CHECK(200 * 150 <= settled.propagateRaster());
+        LABYRINTH_CHECK(0 == settled.propagateRaster());
+
+        settled.setKind(VectorIntXY{ 20, 30 }, CellKind::Hall);
+        LABYRINTH_CHECK(3 * 3 == settled.propagateRaster());
+        LABYRINTH_CHECK(298 == settled.getDistance(VectorIntXY{ 199, 149 }));
+
+        // A new hallway at the far corner lowers half the grid, and the sweeps follow it there.
+        DistanceField bruteForce{ settled };
+        settled.setKind(VectorIntXY{ 199, 149 }, CellKind::Hall);
+        settled.propagateRaster();
+        LABYRINTH_CHECK(0 == settled.getDistance(VectorIntXY{ 199, 149 }));
+        LABYRINTH_CHECK(114 == settled.getDistance(VectorIntXY{ 110, 124 }));
+
+        bruteForce.setKind(VectorIntXY{ 199, 149 }, CellKind::Hall);
+        bruteForce.recalculate();
+        LABYRINTH_CHECK(settled == bruteForce);
+    }
+}
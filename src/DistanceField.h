@@ -0,0 +1,185 @@
+#pragma once
+
+#include "Grid.h"
+#include "VectorIntXY.h"
+#include "WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// What occupies a labyrinth cell.
+    /// </summary>
+    enum class CellKind : std::uint8_t
+    {
+        Open,
+        Room,
+        PotentialDoor,
+        Hall
+    };
+
+    /// <summary>
+    /// Distance from every open cell to the nearest hallway or potential door cell,
+    /// travelling through open cells only.
+    ///
+    /// Stored as a single plane that holds the cell kind and the distance together, two bytes per cell.
+    /// Rooms, potential doors and hallways have the three lowest values. An open cell stores its distance
+    /// plus the hallway value, or the largest value while uncalculated. If a distance ever exceeds what
+    /// 16 bits can hold, the plane is widened to 32 bits, four bytes per cell, and propagation carries on.
+    ///
+    /// Every value a search can write is larger than any kind that is not open, so propagation only compares
+    /// values and never lowers a room, hallway or potential door. The plane has a one cell border of rooms.
+    /// </summary>
+    class DistanceField
+    {
+    public:
+        // Distance of an open cell that no hallway or potential door can reach.
+        static constexpr std::uint32_t UNCALCULATED{ std::numeric_limits<std::uint32_t>::max() };
+
+    private:
+        VectorIntXY m_dimensions{};
+
+        // Only one of the planes is in use at a time.
+        Grid<std::uint16_t> m_compactValues;
+        Grid<std::uint32_t> m_wideValues;
+        bool m_isCompact{ true };
+
+        // When true, clear() always selects the 32 bit plane.
+        bool m_isWideForced{ false };
+
+        // Scratch storage for propagation, kept between calls.
+        std::vector<VectorIntXY> m_queue{};
+        std::vector<VectorIntXY> m_frontier{};
+        std::vector<std::vector<VectorIntXY>> m_nextFrontiers{};
+
+        template <typename Value>
+        struct RasterScratch
+        {
+            // A band of rows stored column by column, so each step along the rows relaxes every row of the band at once.
+            std::vector<Value> band{};
+
+            // Whether each column of the swept rectangle changed.
+            std::vector<Value> columnChanges{};
+        };
+
+        RasterScratch<std::uint16_t> m_compactRasterScratch{};
+        RasterScratch<std::uint32_t> m_wideRasterScratch{};
+
+        // Bounding rectangle of the cells whose kind changed since the last raster propagation, empty when the
+        // minimum is past the maximum. Rooms are left out, since they never lower a distance.
+        VectorIntXY m_rasterDirtyMin{ std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+        VectorIntXY m_rasterDirtyMax{ -1, -1 };
+
+    public:
+        DistanceField() = default;
+        explicit DistanceField(VectorIntXY dimensions);
+
+        /// <summary>
+        /// Make every cell open and uncalculated.
+        /// </summary>
+        void clear();
+
+        /// <summary>
+        /// Always store distances with 32 bits. Takes effect on the next clear().
+        /// </summary>
+        void setWideDistancesForced(bool isForced);
+
+        const VectorIntXY& getDimensions() const;
+        bool isInBounds(VectorIntXY cell) const;
+
+        /// <summary>
+        /// True while cells are stored with 16 bits.
+        /// </summary>
+        bool isCompact() const;
+
+        CellKind getKind(VectorIntXY cell) const;
+
+        /// <summary>
+        /// Zero for rooms, hallways and potential doors. UNCALCULATED for open cells that have not been reached.
+        /// </summary>
+        std::uint32_t getDistance(VectorIntXY cell) const;
+
+        /// <summary>
+        /// Change the kind of a cell. Rooms, hallways and potential doors get a distance of zero,
+        /// open cells become uncalculated.
+        /// </summary>
+        void setKind(VectorIntXY cell, CellKind kind);
+
+        /// <summary>
+        /// Change the kind of every cell of the rectangle with the given minimum corner and size.
+        /// </summary>
+        void setKind(VectorIntXY min, VectorIntXY size, CellKind kind);
+
+        /// <summary>
+        /// Bytes of cell storage currently in use.
+        /// </summary>
+        std::size_t getMemoryUsage() const;
+
+        /// <summary>
+        /// Lower distances with a breadth first search from the given cells.
+        /// Distances only ever decrease, so seeding with only the cells added since the last propagation
+        /// gives the same result as seeding with every hallway and potential door cell.
+        /// Returns the number of cells the search visited, seeds included.
+        /// </summary>
+        std::size_t propagate(const std::vector<VectorIntXY>& seeds, std::size_t firstSeed);
+
+        /// <summary>
+        /// Same result as propagate(), expanding each level of the search in parallel on the given pool.
+        /// </summary>
+        std::size_t propagateParallel(const std::vector<VectorIntXY>& seeds, std::size_t firstSeed, WorkerPool& workerPool);
+
+        /// <summary>
+        /// Same result as propagate() seeded with every hallway and potential door cell, found by sweeping
+        /// the grid instead of following a queue. Each sweep relaxes every cell of a rectangle from its neighbours,
+        /// down the rows and then back up. A row is relaxed from the row before it in one loop along x.
+        /// Every 16 rows, the band they form is copied column by column and relaxed along x in both directions,
+        /// with the inner loop running across the band's rows. No inner loop carries a dependency, so the compiler
+        /// can vectorize them all, with 256 bit vectors when built with LABYRINTH_ENABLE_AVX2.
+        ///
+        /// The first sweep covers the cells whose kind changed since the last raster propagation and their neighbours.
+        /// Each later sweep covers the cells the one before changed, with a margin as wide as they are so widespread
+        /// changes need few sweeps. Sweeps repeat until nothing changes, since rooms can make paths double back.
+        /// Returns the number of cells swept.
+        /// </summary>
+        std::size_t propagateRaster();
+
+        /// <summary>
+        /// Make every open cell uncalculated again and propagate from every hallway and potential door cell,
+        /// so each distance is the exact shortest one for the current cell kinds rather than a lower bound
+        /// left behind by earlier propagations. Returns the number of cells the search visited, seeds included.
+        /// </summary>
+        std::size_t recalculate();
+
+        friend bool operator==(const DistanceField& left, const DistanceField& right);
+
+    private:
+        void widen();
+
+        // Sweep from the given rectangle until nothing changes. False if a distance did not fit in Value.
+        template <typename Value>
+        bool settleRaster(Grid<Value>& values, RasterScratch<Value>& scratch, VectorIntXY min, VectorIntXY max, std::size_t& sweptCount);
+
+        // One sweep over the rectangle. Returns whether any cell changed, and the bounding rectangle of those that did.
+        template <typename Value>
+        bool sweepRaster(
+            Grid<Value>& values,
+            RasterScratch<Value>& scratch,
+            VectorIntXY min,
+            VectorIntXY max,
+            VectorIntXY& changedMin,
+            VectorIntXY& changedMax,
+            bool& isOverflowing);
+
+        template <typename Value>
+        bool propagateQueue(Grid<Value>& values, std::size_t& front);
+
+        template <typename Value>
+        void expandFrontier(Grid<Value>& values, std::uint32_t nextDistance, WorkerPool& workerPool);
+    };
+
+    void runDistanceFieldTests();
+}
@@ -0,0 +1,97 @@
+#include "Grid.h"
+
+#include "SelfTest.h"
+
+#include <set>
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        // Behaviour every layout shares.
+        template <typename Layout>
+        void runGridLayoutTests()
+        {
+            Grid<int, Layout> grid{ VectorIntXY{3, 2}, 7, -1 };
+
+            LABYRINTH_CHECK(grid.getDimensions() == VectorIntXY(3, 2));
+
+            // Interior cells hold the fill value, border cells hold the border value.
+            LABYRINTH_CHECK(grid(0, 0) == 7);
+            LABYRINTH_CHECK(grid(2, 1) == 7);
+            LABYRINTH_CHECK(grid(-1, 0) == -1);
+            LABYRINTH_CHECK(grid(3, 1) == -1);
+            LABYRINTH_CHECK(grid(0, -1) == -1);
+            LABYRINTH_CHECK(grid(2, 2) == -1);
+
+            grid[VectorIntXY{ 1, 1 }] = 3;
+            LABYRINTH_CHECK(grid(1, 1) == 3);
+
+            // Filling does not touch the border.
+            grid.fill(0);
+            LABYRINTH_CHECK(grid(1, 1) == 0);
+            LABYRINTH_CHECK(grid(-1, 1) == -1);
+
+            LABYRINTH_CHECK(grid.isInBounds(VectorIntXY{ 2, 1 }));
+            LABYRINTH_CHECK(!grid.isInBounds(VectorIntXY{ 3, 1 }));
+            LABYRINTH_CHECK(!grid.isInBounds(VectorIntXY{ 0, -1 }));
+
+            // Every cell of a grid and its border has its own place in storage.
+            Grid<int, Layout> larger{ VectorIntXY{ 21, 13 }, 0, 0 };
+            std::set<std::ptrdiff_t> indices{};
+            for (int y = -1; y <= 13; y++)
+            {
+                for (int x = -1; x <= 21; x++)
+                {
+                    std::ptrdiff_t index{ larger.index(x, y) };
+                    LABYRINTH_CHECK(index >= 0 && static_cast<std::size_t>(index) < larger.storageSize());
+                    indices.insert(index);
+                }
+            }
+            LABYRINTH_CHECK(indices.size() == 23 * 15);
+
+            // Resetting to a new size keeps the grid consistent.
+            larger.reset(VectorIntXY{ 2, 2 }, 5, 9);
+            LABYRINTH_CHECK(larger(1, 1) == 5);
+            LABYRINTH_CHECK(larger(2, 1) == 9);
+        }
+    }
+
+    void runGridTests()
+    {
+        runGridLayoutTests<RowMajorGridLayout>();
+        runGridLayoutTests<TiledGridLayout>();
+
+        // Row-major storage is contiguous.
+        Grid<int, RowMajorGridLayout> grid{ VectorIntXY{3, 2}, 7, -1 };
+        LABYRINTH_CHECK(grid.getStride() == 5);
+        LABYRINTH_CHECK(grid.storageSize() == 20);
+
+        grid[VectorIntXY{ 1, 1 }] = 3;
+        LABYRINTH_CHECK(grid.row(1)[1] == 3);
+        LABYRINTH_CHECK(&grid(2, 1) - &grid(1, 1) == 1);
+        LABYRINTH_CHECK(&grid(1, 1) - &grid(1, 0) == grid.getStride());
+
+        // Padded rows round the stride up to the alignment.
+        Grid<unsigned char, RowMajorGridLayout> padded{ VectorIntXY{10, 4}, 1, 0, 16 };
+        LABYRINTH_CHECK(padded.getStride() == 16);
+        LABYRINTH_CHECK(padded(9, 3) == 1);
+        LABYRINTH_CHECK(padded(10, 3) == 0);
+
+        padded.reset(VectorIntXY{ 2, 2 }, 5, 9);
+        LABYRINTH_CHECK(padded.getStride() == 4);
+
+        // Tiles hold square blocks of cells, in Z-order within a tile. The border shifts cells by one.
+        Grid<int, TiledGridLayout> tiled{ VectorIntXY{ 20, 10 }, 0, 0 };
+        const int tileCells{ TiledGridLayout::TILE_SIZE * TiledGridLayout::TILE_SIZE };
+        LABYRINTH_CHECK(tiled.storageSize() == 3 * 2 * tileCells);
+        LABYRINTH_CHECK(tiled.index(-1, -1) == 0);
+        LABYRINTH_CHECK(tiled.index(0, -1) == 1);
+        LABYRINTH_CHECK(tiled.index(-1, 0) == 2);
+        LABYRINTH_CHECK(tiled.index(0, 0) == 3);
+        LABYRINTH_CHECK(tiled.index(1, -1) == 4);
+        LABYRINTH_CHECK(tiled.index(6, 6) == tileCells - 1);
+        LABYRINTH_CHECK(tiled.index(7, -1) == tileCells);
+        LABYRINTH_CHECK(tiled.index(-1, 7) == 3 * tileCells);
+    }
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "VectorIntXY.h"
+
+#include <cstddef>
+#include <vector>
+
+// Define as 1 to store every grid in Z-order tiles instead of row by row. See TiledGridLayout.
+#ifndef LABYRINTH_GRID_LAYOUT_TILED
+#define LABYRINTH_GRID_LAYOUT_TILED 0
+#endif
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Cells stored row by row. Rows can optionally be padded so the stride is a multiple of a given number of cells.
+    /// </summary>
+    class RowMajorGridLayout
+    {
+        // Number of stored cells per row, including the border and padding.
+        std::ptrdiff_t m_stride{};
+
+    public:
+        static constexpr bool IS_ROW_MAJOR{ true };
+
+        /// <summary>
+        /// Lay out a grid of the given dimensions plus its border. Returns the number of cells to store.
+        /// </summary>
+        std::size_t reset(VectorIntXY dimensions, int rowAlignment)
+        {
+            if (rowAlignment < 1) { rowAlignment = 1; }
+
+            std::ptrdiff_t paddedWidth{ dimensions.x + 2 };
+            m_stride = ((paddedWidth + rowAlignment - 1) / rowAlignment) * rowAlignment;
+
+            return static_cast<std::size_t>(m_stride * (dimensions.y + 2));
+        }
+
+        std::ptrdiff_t getStride() const { return m_stride; }
+
+        std::ptrdiff_t index(int x, int y) const
+        {
+            return ((y + 1) * m_stride) + (x + 1);
+        }
+    };
+
+    /// <summary>
+    /// Cells stored in square tiles, one tile after another row by row, with the cells of a tile in Z-order
+    /// (Morton order): the bits of a cell's x and y offsets within the tile interleaved.
+    /// Cells close to each other in both x and y share cache lines, so stepping up or down a row
+    /// costs about as much as stepping along it. Rows are not contiguous, so there is no row alignment.
+    /// </summary>
+    class TiledGridLayout
+    {
+        static constexpr int TILE_BITS{ 3 };
+
+        // Tiles per row of tiles, counting the border.
+        std::ptrdiff_t m_tilesPerRow{};
+
+        // Move the low TILE_BITS bits of an offset to every other bit.
+        static constexpr std::ptrdiff_t spreadBits(int offset)
+        {
+            std::ptrdiff_t spread{ 0 };
+            for (int bit = 0; bit < TILE_BITS; bit++)
+            {
+                spread |= static_cast<std::ptrdiff_t>((offset >> bit) & 1) << (2 * bit);
+            }
+
+            return spread;
+        }
+
+    public:
+        static constexpr bool IS_ROW_MAJOR{ false };
+        static constexpr int TILE_SIZE{ 1 << TILE_BITS };
+
+        std::size_t reset(VectorIntXY dimensions, int)
+        {
+            m_tilesPerRow = (dimensions.x + 2 + TILE_SIZE - 1) / TILE_SIZE;
+            std::ptrdiff_t tileRows{ (dimensions.y + 2 + TILE_SIZE - 1) / TILE_SIZE };
+
+            return static_cast<std::size_t>(m_tilesPerRow * tileRows * TILE_SIZE * TILE_SIZE);
+        }
+
+        std::ptrdiff_t index(int x, int y) const
+        {
+            int paddedX{ x + 1 };
+            int paddedY{ y + 1 };
+            std::ptrdiff_t tile{ ((paddedY >> TILE_BITS) * m_tilesPerRow) + (paddedX >> TILE_BITS) };
+
+            return (tile << (2 * TILE_BITS)) | spreadBits(paddedX & (TILE_SIZE - 1)) | (spreadBits(paddedY & (TILE_SIZE - 1)) << 1);
+        }
+    };
+
+#if LABYRINTH_GRID_LAYOUT_TILED
+    using GridLayout = TiledGridLayout;
+#else
+    using GridLayout = RowMajorGridLayout;
+#endif
+
+    /// <summary>
+    /// Contiguous 2D grid of cells, stored in the given layout. Grids are row-major unless
+    /// LABYRINTH_GRID_LAYOUT_TILED selects tiles, and code that works with any layout only goes through the cell accessors.
+    ///
+    /// The grid is surrounded by a one cell border holding a fixed border value,
+    /// so reading the neighbour of any cell inside the grid never leaves the allocation.
+    /// Border cells are addressed with coordinates -1 and dimensions.x / dimensions.y.
+    /// </summary>
+    template <typename T, typename Layout = GridLayout>
+    class Grid
+    {
+        VectorIntXY m_dimensions{};
+
+        Layout m_layout{};
+
+        T m_borderValue{};
+
+        std::vector<T> m_cells{};
+
+    public:
+        Grid() = default;
+
+        Grid(VectorIntXY dimensions, T fillValue, T borderValue, int rowAlignment = 1)
+        {
+            reset(dimensions, fillValue, borderValue, rowAlignment);
+        }
+
+        /// <summary>
+        /// Resize the grid, reusing the existing allocation when it is large enough.
+        /// Row alignment only applies to row-major grids.
+        /// </summary>
+        void reset(VectorIntXY dimensions, T fillValue, T borderValue, int rowAlignment = 1)
+        {
+            m_dimensions = dimensions;
+            m_borderValue = borderValue;
+
+            m_cells.assign(m_layout.reset(dimensions, rowAlignment), borderValue);
+            fill(fillValue);
+        }
+
+        /// <summary>
+        /// Set every cell inside the grid to the given value. The border is left untouched.
+        /// </summary>
+        void fill(T value)
+        {
+            for (int y = 0; y < m_dimensions.y; y++)
+            {
+                for (int x = 0; x < m_dimensions.x; x++)
+                {
+                    m_cells[index(x, y)] = value;
+                }
+            }
+        }
+
+        const VectorIntXY& getDimensions() const { return m_dimensions; }
+
+        std::ptrdiff_t getStride() const requires Layout::IS_ROW_MAJOR { return m_layout.getStride(); }
+
+        const T& getBorderValue() const { return m_borderValue; }
+
+        bool isInBounds(VectorIntXY cell) const
+        {
+            return
+                (cell.x >= 0) &&
+                (cell.y >= 0) &&
+                (cell.x < m_dimensions.x) &&
+                (cell.y < m_dimensions.y);
+        }
+
+        /// <summary>
+        /// Offset of the given cell from the start of the storage.
+        /// Valid for every cell inside the grid and its border.
+        /// </summary>
+        std::ptrdiff_t index(int x, int y) const
+        {
+            return m_layout.index(x, y);
+        }
+
+        T& operator()(int x, int y) { return m_cells[index(x, y)]; }
+        const T& operator()(int x, int y) const { return m_cells[index(x, y)]; }
+
+        T& operator[](VectorIntXY cell) { return m_cells[index(cell.x, cell.y)]; }
+        const T& operator[](VectorIntXY cell) const { return m_cells[index(cell.x, cell.y)]; }
+
+        /// <summary>
+        /// Pointer to cell (0, y) of a row-major grid. Cells -1 and dimensions.x of the row are border cells.
+        /// </summary>
+        T* row(int y) requires Layout::IS_ROW_MAJOR { return m_cells.data() + index(0, y); }
+        const T* row(int y) const requires Layout::IS_ROW_MAJOR { return m_cells.data() + index(0, y); }
+
+        T* data() { return m_cells.data(); }
+        const T* data() const { return m_cells.data(); }
+
+        std::size_t storageSize() const { return m_cells.size(); }
+    };
+
+    void runGridTests();
+}
@@ -0,0 +1,158 @@
+#include "GridRay.h"
+
+#include "CellUnitConverter.h"
+#include "Random.h"
+#include "SelfTest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    GridRay::GridRay(VectorIntXY startCell, VectorXY direction) :
+        m_cell{ startCell }
+    {
+        std::int64_t directionX{ std::llround(direction.x * FIXED_POINT_SCALE) };
+        std::int64_t directionY{ std::llround(direction.y * FIXED_POINT_SCALE) };
+        if (directionX == 0 && directionY == 0)
+        {
+            directionX = 1;
+        }
+
+        std::int64_t lengthX{ directionX < 0 ? -directionX : directionX };
+        std::int64_t lengthY{ directionY < 0 ? -directionY : directionY };
+        VectorIntXY stepX{ directionX < 0 ? -1 : 1, 0 };
+        VectorIntXY stepY{ 0, directionY < 0 ? -1 : 1 };
+
+        // Equal components make y the major axis, and x then steps every time too.
+        bool isMajorAxisX{ lengthX > lengthY };
+        m_majorStep = isMajorAxisX ? stepX : stepY;
+        m_minorStep = isMajorAxisX ? stepY : stepX;
+        m_majorLength = isMajorAxisX ? lengthX : lengthY;
+        m_minorLength = isMajorAxisX ? lengthY : lengthX;
+
+        bool isMinorNegative{ (isMajorAxisX ? directionY : directionX) < 0 };
+        m_remainder = isMinorNegative ? m_majorLength - 1 : 0;
+    }
+
+    VectorXY legacyNextCoordinateAlongSearchPath(VectorXY currentPosition, VectorXY searchDirection, double cellUnit)
+    {
+        double nextX, nextY;
+
+        if (searchDirection.x > 0)
+        {
+            nextX = currentPosition.x + cellUnit;
+        }
+        else
+        {
+            nextX = currentPosition.x - cellUnit;
+        }
+
+        if (searchDirection.y > 0)
+        {
+            nextY = currentPosition.y + cellUnit;
+        }
+        else
+        {
+            nextY = currentPosition.y - cellUnit;
+        }
+
+        // Use z = mx + b to fill in missing values.
+        // m: slope
+        // b: z such that x = 0
+        double slope = searchDirection.y / searchDirection.x;
+        double yIntercept = currentPosition.y - (slope * currentPosition.x); // b = z - (m * x)
+        VectorXY targetInterceptX = VectorXY{
+            nextX,
+            (slope * nextX) + yIntercept // y = (m * x) + b
+        };
+        VectorXY targetInterceptZ = VectorXY{
+            (nextY - yIntercept) / slope, // x = (y - b) / m
+            nextY
+        };
+
+        // Choose closest candidate as new currentPosition
+        if (VectorXY::distanceSquared(currentPosition, targetInterceptX) < VectorXY::distanceSquared(currentPosition, targetInterceptZ))
+        {
+            return targetInterceptX;
+        }
+        else
+        {
+            return targetInterceptZ;
+        }
+    }
+
+    void runGridRayTests()
+    {
+        auto walk = [](VectorIntXY startCell, VectorXY direction, int stepCount)
+        {
+            GridRay ray{ startCell, direction };
+            std::vector<VectorIntXY> cells{};
+            for (int i = 0; i < stepCount; i++)
+            {
+                cells.push_back(ray.step());
+            }
+            return cells;
+        };
+
+        // Axis aligned rays walk a single row or column, whatever the length of the direction.
+        {
+            GridRay ray{ VectorIntXY{ 5, 5 }, VectorXY{ 0, 1 } };
+            LABYRINTH_CHECK(VectorIntXY(5, 5) == ray.getCell());
+            LABYRINTH_CHECK((std::vector<VectorIntXY>{ { 5, 6 }, { 5, 7 } }) == walk(VectorIntXY{ 5, 5 }, VectorXY{ 0, 1 }, 2));
+            LABYRINTH_CHECK((std::vector<VectorIntXY>{ { 4, 5 }, { 3, 5 } }) == walk(VectorIntXY{ 5, 5 }, VectorXY{ -1, 0 }, 2));
+            LABYRINTH_CHECK((std::vector<VectorIntXY>{ { 5, 4 }, { 5, 3 } }) == walk(VectorIntXY{ 5, 5 }, VectorXY{ 0, -0.5 }, 2));
+        }
+
+        // A zero direction still moves, so a search along it reaches the edge.
+        LABYRINTH_CHECK((std::vector<VectorIntXY>{ { 1, 0 }, { 2, 0 } }) == walk(VectorIntXY{ 0, 0 }, VectorXY{ 0, 0 }, 2));
+
+        // Diagonal rays move along both axes every step.
+        LABYRINTH_CHECK((std::vector<VectorIntXY>{ { 1, 1 }, { 2, 2 }, { 3, 3 } }) == walk(VectorIntXY{ 0, 0 }, VectorXY{ 1, 1 }, 3));
+        LABYRINTH_CHECK((std::vector<VectorIntXY>{ { -1, 1 }, { -2, 2 } }) == walk(VectorIntXY{ 0, 0 }, VectorXY{ -0.5, 0.5 }, 2));
+
+        // A shallow ray moves one column per step, in the row its position along y rounds down to:
+        // y = 0.25, 0.5, 0.75, 1, 1.25.
+        LABYRINTH_CHECK((std::vector<VectorIntXY>{ { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 1 }, { 5, 1 } }) ==
+            walk(VectorIntXY{ 0, 0 }, VectorXY{ 1, 0.25 }, 5));
+
+        // Going down, y = -0.375, -0.75, -1.125, -1.5, -1.875, -2.25, -2.625, -3 also round down,
+        // and landing exactly on a boundary gives the cell beyond it.
+        LABYRINTH_CHECK((std::vector<VectorIntXY>{ { 1, -1 }, { 2, -1 }, { 3, -2 }, { 4, -2 }, { 5, -2 }, { 6, -3 }, { 7, -3 }, { 8, -3 } }) ==
+            walk(VectorIntXY{ 0, 0 }, VectorXY{ 1, -0.375 }, 8));
+
+        // A steep ray moves one row per step: x = 3.5, 4, 4.5, 5 going down, and x = -0.25, ..., -1.25 going up and left.
+        LABYRINTH_CHECK((std::vector<VectorIntXY>{ { 3, 2 }, { 4, 1 }, { 4, 0 }, { 5, -1 } }) ==
+            walk(VectorIntXY{ 3, 3 }, VectorXY{ 0.5, -1 }, 4));
+        LABYRINTH_CHECK((std::vector<VectorIntXY>{ { -1, 1 }, { -1, 2 }, { -1, 3 }, { -1, 4 }, { -2, 5 } }) ==
+            walk(VectorIntXY{ 0, 0 }, VectorXY{ -0.25, 1 }, 5));
+
+        // Rays visit the same cells as the floating point stepping they replaced, in every direction but vertical ones,
+        // which it divides by zero on. Starts and cell units vary so positions in meters are not always whole numbers.
+        {
+            Xoshiro256StarStar random{ 17u };
+            for (int i = 0; i < 2000; i++)
+            {
+                VectorXY direction{ randomDouble(random, -1.0, 1.0), randomDouble(random, -1.0, 1.0) };
+                if (direction.x == 0)
+                {
+                    continue;
+                }
+
+                double cellUnit{ i % 2 == 0 ? 2.0 : 0.75 };
+                CellUnitConverter converter{ cellUnit };
+                VectorIntXY startCell{ static_cast<int>(randomIndex(random, 200)) - 100, static_cast<int>(randomIndex(random, 200)) - 100 };
+                int stepCount{ 1 + static_cast<int>(randomIndex(random, 300)) };
+
+                GridRay ray{ startCell, direction };
+                VectorXY position{ converter.cellToMeters(startCell.x), converter.cellToMeters(startCell.y) };
+                for (int step = 0; step < stepCount; step++)
+                {
+                    position = legacyNextCoordinateAlongSearchPath(position, direction, cellUnit);
+                    VectorIntXY legacyCell{ converter.metersToCellFloor(position.x), converter.metersToCellFloor(position.y) };
+                    LABYRINTH_CHECK(legacyCell == ray.step());
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "VectorIntXY.h"
+#include "VectorXY.h"
+
+#include <cstdint>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Walks a room search path from a start cell, one cell along the direction's major axis per step,
+    /// to the cell the ray is in there. The ray starts at the minimum corner of its start cell, so the minor
+    /// coordinate is the floor of the ray's position along its minor axis. When both components are equally large,
+    /// both coordinates change every step. A zero direction walks along positive x.
+    ///
+    /// This is the path LabyrinthBuilder's floating point stepping followed before, which converted
+    /// a position in meters back to cells every step. Here the direction is converted to fixed point once
+    /// and the minor coordinate follows from an integer remainder, so stepping needs no division or floating point,
+    /// and axis aligned directions need no special case.
+    /// </summary>
+    class GridRay
+    {
+        VectorIntXY m_cell;
+
+        // Every step moves the cell by m_majorStep, and also by m_minorStep when the remainder reaches m_majorLength.
+        VectorIntXY m_majorStep;
+        VectorIntXY m_minorStep;
+
+        // Fixed point length of the larger and the smaller direction component.
+        std::int64_t m_majorLength;
+        std::int64_t m_minorLength;
+
+        // After k steps, k * m_minorLength modulo m_majorLength. Negative minor directions start it at m_majorLength - 1,
+        // so their minor coordinate also rounds down rather than towards the start cell.
+        std::int64_t m_remainder;
+
+    public:
+        // Direction components are scaled by this before rounding to integers. Scaling a double by a power of two is exact,
+        // and twice the scale still fits the remainder.
+        static constexpr double FIXED_POINT_SCALE{ static_cast<double>(std::int64_t{ 1 } << 61) };
+
+        /// <summary>
+        /// Direction components must lie in [-1, 1].
+        /// </summary>
+        GridRay(VectorIntXY startCell, VectorXY direction);
+
+        const VectorIntXY& getCell() const { return m_cell; }
+
+        /// <summary>
+        /// Move to the next cell along the ray and return it.
+        /// </summary>
+        const VectorIntXY& step()
+        {
+            m_cell = m_cell + m_majorStep;
+            m_remainder += m_minorLength;
+
+            if (m_remainder >= m_majorLength)
+            {
+                m_remainder -= m_majorLength;
+                m_cell = m_cell + m_minorStep;
+            }
+
+            return m_cell;
+        }
+    };
+
+    /// <summary>
+    /// The floating point search path stepping LabyrinthBuilder used before GridRay, kept to test and benchmark GridRay against.
+    /// Returns the next position along the path, in meters. Divides by zero for vertical directions.
+    /// </summary>
+    VectorXY legacyNextCoordinateAlongSearchPath(VectorXY currentPosition, VectorXY searchDirection, double cellUnit);
+
+    void runGridRayTests();
+}
@@ -1,24 +1,67 @@
 #include "LabyrinthBuilder.h"
 
+#include "AllocationCounter.h"
+#include "GridRay.h"
+#include "SelfTest.h"
+#include "TextRenderer.h"
+
 #include <algorithm>
 #include <cassert>
-#include <format>
-#include <queue>
+#include <chrono>
+#include <string>
 
 namespace LabyrinthGeneration
 {
-    LabyrinthBuilder::LabyrinthBuilder(
+    template <typename RandomEngine>
+    BasicLabyrinthBuilder<RandomEngine>::BasicLabyrinthBuilder(
         VectorIntXY labyrinthDimensions,
         int numRoomsToSpawn,
         double cellUnit,
         Room room,
-        std::optional<unsigned int> randomSeed) :
+        std::optional<std::uint64_t> randomSeed) :
+        BasicLabyrinthBuilder{ labyrinthDimensions, numRoomsToSpawn, RoomTemplate{ room, cellUnit }, randomSeed }
+    {
+    }
+
+    template <typename RandomEngine>
+    BasicLabyrinthBuilder<RandomEngine>::BasicLabyrinthBuilder(
+        VectorIntXY labyrinthDimensions,
+        int numRoomsToSpawn,
+        RoomTemplate roomTemplate,
+        std::optional<std::uint64_t> randomSeed) :
+        BasicLabyrinthBuilder{
+            labyrinthDimensions,
+            numRoomsToSpawn,
+            roomTemplate.getCellUnit(),
+            std::vector<CompiledRoomType>{ CompiledRoomType{ roomTemplate, 1, 0, std::numeric_limits<int>::max() } },
+            randomSeed }
+    {
+    }
+
+    template <typename RandomEngine>
+    BasicLabyrinthBuilder<RandomEngine>::BasicLabyrinthBuilder(
+        VectorIntXY labyrinthDimensions,
+        int numRoomsToSpawn,
+        double cellUnit,
+        const std::vector<RoomType>& roomTypes,
+        std::optional<std::uint64_t> randomSeed) :
+        BasicLabyrinthBuilder{ labyrinthDimensions, numRoomsToSpawn, cellUnit, compileRoomTypes(roomTypes, cellUnit), randomSeed }
+    {
+    }
+
+    template <typename RandomEngine>
+    BasicLabyrinthBuilder<RandomEngine>::BasicLabyrinthBuilder(
+        VectorIntXY labyrinthDimensions,
+        int numRoomsToSpawn,
+        double cellUnit,
+        std::vector<CompiledRoomType> roomTypes,
+        std::optional<std::uint64_t> randomSeed) :
         m_randomSeed{ randomSeed },
+        m_labyrinthDimensions{ labyrinthDimensions },
         m_numRoomsToSpawn{numRoomsToSpawn},
-        m_cellUnit{cellUnit},
-        m_room{room},
-        m_converter{ m_cellUnit },
-        m_labyrinthDimensions{ labyrinthDimensions }
+        m_cellUnit{ cellUnit },
+        m_roomTypes{ std::move(roomTypes) },
+        m_converter{ m_cellUnit }
     {
         if (labyrinthDimensions.x < 1 || labyrinthDimensions.y < 1)
         {
@@ -27,452 +70,1317 @@ namespace LabyrinthGeneration
             throw std::runtime_error((error));
         }
 
-        if (cellUnit == 0)
+        if (m_cellUnit == 0)
         {
             std::string error{ "LabyrinthBuilder cell unit cannot be zero!" };
             std::cerr << error;
             throw std::runtime_error((error));
         }
 
-        m_distanceField = std::vector(m_labyrinthDimensions.y, std::vector<int>(m_labyrinthDimensions.x));
-    }
+        if (m_roomTypes.empty())
+        {
+            std::string error{ "LabyrinthBuilder needs at least one room type!" };
+            std::cerr << error;
+            throw std::runtime_error((error));
+        }
 
-    void LabyrinthBuilder::build()
-    {
-        // Wipe the distance field
-        for (int y = 0; y < m_labyrinthDimensions.y; y++)
+        long long minimumRoomCount{ 0 };
+        for (const CompiledRoomType& roomType : m_roomTypes)
         {
-            for (int x = 0; x < m_labyrinthDimensions.x; x++)
+            if (roomType.weight < 0 || roomType.minCount < 0 || roomType.maxCount < roomType.minCount)
             {
-                m_distanceField[y][x] = DISTANCE_FIELD_UNCALCULATED;
+                std::string error{ "LabyrinthBuilder room types need a weight of at least zero and 0 <= minCount <= maxCount!" };
+                std::cerr << error;
+                throw std::runtime_error((error));
             }
-        }
 
-        if (m_numRoomsToSpawn < 1)
-        {
-            return;
+            minimumRoomCount += roomType.minCount;
         }
 
-        // Set up random number generator
-        if (m_randomSeed.has_value())
-        { 
-            m_randomGenerator.seed(m_randomSeed.value());
-        }
-        else
+        if (minimumRoomCount > std::max(m_numRoomsToSpawn, 0))
         {
-            unsigned int seed = static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count());
-            std::cout << "Using random seed: " << seed << "\n";
-            m_randomGenerator.seed(seed);
+            std::string error{ "LabyrinthBuilder room type minimum counts add up to more rooms than it spawns!" };
+            std::cerr << error;
+            throw std::runtime_error((error));
         }
 
-        spawnRooms();
-
-        debugCoutDistanceField();
+        m_result.distanceField = DistanceField(m_labyrinthDimensions);
+        m_result.cellUnit = m_cellUnit;
+        m_occupancy = OccupancyBitboard(m_labyrinthDimensions);
+        m_roomTypeCounts.resize(m_roomTypes.size());
+        m_eligibleRoomTypeWeights.resize(m_roomTypes.size());
     }
 
-    void LabyrinthBuilder::spawnRooms()
+    template <typename RandomEngine>
+    auto BasicLabyrinthBuilder<RandomEngine>::compileRoomTypes(const std::vector<RoomType>& roomTypes, double cellUnit) -> std::vector<CompiledRoomType>
     {
-        spawnFirstRoom();
-        recalculateDistanceField();
-
-        VectorIntXY center{m_labyrinthDimensions.x / 2, m_labyrinthDimensions.y / 2 };
-        int numToSpawn{ m_numRoomsToSpawn - 1 };
-
-        // Set up a distribution for the random number generator
-        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        std::vector<CompiledRoomType> compiled{};
+        compiled.reserve(roomTypes.size());
 
-        while (numToSpawn > 0)
+        for (const RoomType& roomType : roomTypes)
         {
-            // Pick a random direction
-            VectorXY direction{
-                distribution(m_randomGenerator) ,
-                distribution(m_randomGenerator) };
-
-            // Find an open space.
-            // Start at center and move in the chosen direction looking for enough space for the new room.
-            int roomsizeX = m_converter.metersToCellRound(m_room.getDimensions().x);
-            int roomsizeY = m_converter.metersToCellRound(m_room.getDimensions().y);
-
-            VectorXY potentialRoomPosition{
-                m_converter.cellToMeters(center.x),
-                m_converter.cellToMeters(center.y)
-            };
-
-            VectorIntXY potentialRoomCoordinates{ center.x, center.y };
-            bool foundSpawn{ false };
+            compiled.push_back(CompiledRoomType{ RoomTemplate{ roomType.room, cellUnit }, roomType.weight, roomType.minCount, roomType.maxCount });
+        }
 
-            // Search for open space along the search path until:
-            // 1. we find open space or
-            // 2. we hit the edge.
-            while (areRoomExtentsWithinLabyrinth(potentialRoomCoordinates, roomsizeX, roomsizeY))
-            {
-                bool roomPositionValid = true;
+        return compiled;
+    }
 
-                // if we find overlap, increment our distance and continue
-                for (int y = 0; y < roomsizeY; y++)
-                {
-                    if (!roomPositionValid) { break; }
+    template <typename RandomEngine>
+    const LabyrinthResult& BasicLabyrinthBuilder<RandomEngine>::build()
+    {
+        m_result.stats = LabyrinthStats{};
+        ScopedPhaseTimer buildTimer{ m_result.stats.totalTime };
 
-                    for (int x = 0; x < roomsizeX; x++)
-                    {
-                        int cellValue = m_distanceField[potentialRoomCoordinates.y + y][potentialRoomCoordinates.x + x];
-                        if (cellValue == DISTANCE_FIELD_ROOM || cellValue <= 0)
-                        {
-                            potentialRoomPosition = nextCoordinateAlongSearchPath(potentialRoomPosition, direction);
-                            potentialRoomCoordinates = VectorIntXY(
-                                m_converter.metersToCellFloor(potentialRoomPosition.x),
-                                m_converter.metersToCellFloor(potentialRoomPosition.y));
-
-                            // break out to while loop
-                            roomPositionValid = false;
-                            break;
-                        }
-                    }
-                }
+        // Wipe the distance field
+        m_result.distanceField.clear();
+        m_result.rooms.clear();
+        m_result.hallwayCells.clear();
+        m_result.status = BuildStatus::Complete;
+        m_zeroDistanceCoordinates.clear();
+        m_occupancy.clear();
+        m_propagatedZeroDistanceCount = 0;
+
+        if (m_placementStrategy == PlacementStrategy::FreeSpaceIndex)
+        {
+            resetPlacementIndexes();
+        }
 
-                // otherwise, we have found our spawn position
-                if (roomPositionValid)
-                {
-                    foundSpawn = true;
-                    break;
-                }
-            }
+        std::fill(m_roomTypeCounts.begin(), m_roomTypeCounts.end(), 0);
+        m_outstandingMinimumCount = 0;
+        for (const CompiledRoomType& roomType : m_roomTypes)
+        {
+            m_outstandingMinimumCount += roomType.minCount;
+        }
+        m_isFillingMinimums = false;
+        m_isRoomTypeSelectionDirty = true;
 
-            if (!foundSpawn)
+        // Keep rooms off the boundary doors so they can always be connected.
+        for (VectorIntXY cell : m_boundaryDoorCells)
+        {
+            if (isInDistanceField(cell))
             {
-                std::cout << "LabyrinthBuilder could not spawn a room along a search path! Trying a new path.\n";
-                continue; // try again
+                blockCell(cell);
             }
-            else
+        }
+
+        // Set up random number generator
+        if (m_randomSeed.has_value())
+        { 
+            m_result.randomSeed = m_randomSeed.value();
+        }
+        else
+        {
+            m_result.randomSeed = static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+            if (m_logger.isEnabled(LogLevel::Info))
             {
-                numToSpawn--;
+                m_logger.write(LogLevel::Info, "Using random seed: " + std::to_string(m_result.randomSeed));
             }
+        }
+        m_attemptIndex = 0;
 
-            spawnRoom(potentialRoomCoordinates);
+        if (m_numRoomsToSpawn < 1)
+        {
+            return m_result;
+        }
 
-            connectToExistingRooms(potentialRoomCoordinates, m_room);
+        spawnRooms();
 
-            addRoomDoorsToDistanceField(potentialRoomCoordinates);
+        connectBoundaryDoors();
 
-            // Update distance field
+        // Hallways were routed without the distance field, so it is propagated once, from every hallway and potential door.
+        if (m_distanceFieldUpdateMode == DistanceFieldUpdateMode::Deferred)
+        {
             recalculateDistanceField();
         }
-    }
-
-    void LabyrinthBuilder::spawnFirstRoom()
-    {
-        Vector3 roomWorldSpaceDimensions{ m_room.getDimensions() };
-        VectorIntXY roomCellDimensions{ m_converter.metersToCellRound(roomWorldSpaceDimensions.x), m_converter.metersToCellRound(roomWorldSpaceDimensions.y) };
 
-        VectorIntXY roomSpawnCell
+        if constexpr (ARE_STATS_ENABLED)
         {
-            (m_labyrinthDimensions.x / 2) - (roomCellDimensions.x / 2),
-            (m_labyrinthDimensions.y / 2) - (roomCellDimensions.y / 2)
-        };
+            m_result.stats.hallwayLength = m_result.hallwayCells.size();
+        }
 
-        spawnRoom(roomSpawnCell);
+        return m_result;
+    }
 
-        addRoomDoorsToDistanceField(roomSpawnCell);
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setDistanceFieldUpdateMode(DistanceFieldUpdateMode mode)
+    {
+        m_distanceFieldUpdateMode = mode;
     }
 
-    /// <summary>
-    /// Spawn a room at the given location, which is the x, y minimum extent of the room.
-    /// </summary>
-    /// <param name="labyrinthCoordinate"></param>
-    void LabyrinthBuilder::spawnRoom(VectorIntXY cell)
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setDistanceFieldEngine(DistanceFieldEngine engine)
     {
-        addRoomToDistanceField(cell);
+        m_distanceFieldEngine = engine;
     }
 
-    void LabyrinthBuilder::addRoomToDistanceField(VectorIntXY cell)
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setPlacementStrategy(PlacementStrategy strategy)
     {
-        Vector3 roomWorldSpaceDimensions{ m_room.getDimensions() };
-        VectorIntXY roomCellDimensions{ m_converter.metersToCellRound(roomWorldSpaceDimensions.x), m_converter.metersToCellRound(roomWorldSpaceDimensions.y) };
+        m_placementStrategy = strategy;
+    }
 
-        // Make room tiles distance max int. Max int denotes not passable.
-        for (int y = 0; y < roomCellDimensions.y; y++)
-        {
-            for (int x = 0; x < roomCellDimensions.x; x++)
-            {
-                int currentRoomX = cell.x + x;
-                int currentRoomY = cell.y + y;
-                m_distanceField[currentRoomY][currentRoomX] = DISTANCE_FIELD_ROOM;
-            }
-        }
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setRandomSeed(std::optional<std::uint64_t> randomSeed)
+    {
+        m_randomSeed = randomSeed;
     }
 
-    void LabyrinthBuilder::addRoomDoorsToDistanceField(VectorIntXY cell)
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setBoundaryDoorCells(const std::vector<VectorIntXY>& cells)
     {
-        // Mark the space outside each door as a potential door.
-        for (const PlaneTransform& door : m_room.getDoors())
-        {
-            VectorIntXY doorCoordinate{ findDoorCoordinate(cell, door) };
+        m_boundaryDoorCells = cells;
+    }
 
-            // Make sure we are still in the array and not overriding a room
-            if (!isInDistanceField(doorCoordinate) || m_distanceField[doorCoordinate.y][doorCoordinate.x] == DISTANCE_FIELD_ROOM)
-            {
-                continue;
-            }
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setLogLevel(LogLevel level)
+    {
+        m_logger.setLevel(level);
+    }
 
-            // Make that coordinate 0 in the distance field
-            setPotentialDoorCell(doorCoordinate);
-        }
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setLogSink(LogSink sink)
+    {
+        m_logger.setSink(std::move(sink));
     }
 
-    /// <summary>
-    /// Spawn the specified door
-    /// from the perspective of the local space of the provided cell.
-    /// </summary>
-    /// <param name="cell"></param>
-    /// <param name="door"></param>
-    VectorIntXY LabyrinthBuilder::findDoorCoordinate(VectorIntXY roomCell, PlaneTransform door)
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setParallelDistanceFieldThreshold(std::size_t cellCount)
     {
-        // Move door position forward into an adjoining cell.
-        // The provided position is the door prefab spawn position.
-        // The forward direction of the provided transform indicates "out of the room"
-        // Adding half of a unit also accounts for float precision.
-        Vector3 doorPosition = door.getPosition();
-        Vector3 hallPosition = Vector3{ doorPosition.x, doorPosition.y, doorPosition.z };
-        VectorXY doorForward{ door.getForward().x, door.getForward().y};
-        hallPosition = hallPosition + ((Vector3{ doorForward.x, doorForward.y, 0 } * 0.5f));
+        m_parallelDistanceFieldThreshold = cellCount;
+    }
 
-        // Translate to coordinate in grid
-        int doorX{ roomCell.x + m_converter.metersToCellFloor(hallPosition.x) };
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setDistanceFieldThreadCount(std::size_t threadCount)
+    {
+        if (threadCount != m_distanceFieldThreadCount)
+        {
+            m_workerPool.reset();
+        }
 
-        int doorY{ roomCell.y + m_converter.metersToCellFloor(hallPosition.y) };
+        m_distanceFieldThreadCount = threadCount;
+    }
 
-        return VectorIntXY{ doorX, doorY };
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setPlacementCandidateCount(std::size_t count)
+    {
+        m_placementCandidateCount = std::max(count, std::size_t{ 1 });
     }
 
-    bool LabyrinthBuilder::isInDistanceField(VectorIntXY cell)
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setMaxConsecutiveFailedAttempts(std::uint64_t count)
     {
-        return 
-            (cell.x >= 0) && 
-            (cell.y >= 0) && 
-            (cell.x < m_labyrinthDimensions.x) && 
-            (cell.y < m_labyrinthDimensions.y);
+        m_maxConsecutiveFailedAttempts = std::max(count, std::uint64_t{ 1 });
     }
 
-    bool LabyrinthBuilder::areRoomExtentsWithinLabyrinth(VectorIntXY position, int sizeX, int sizeY)
+    template <typename RandomEngine>
+    const OccupancyBitboard& BasicLabyrinthBuilder<RandomEngine>::getOccupancy() const
     {
-        return
-            isInDistanceField(position + VectorIntXY{ 0, sizeY }) &&
-            isInDistanceField(position) &&
-            isInDistanceField(position + VectorIntXY{ sizeX, 0 }) &&
-            isInDistanceField(position + VectorIntXY{ sizeX, sizeY });
+        return m_occupancy;
     }
 
-    void LabyrinthBuilder::setPotentialDoorCell(VectorIntXY cell)
+    template <typename RandomEngine>
+    const PlacementCounters& BasicLabyrinthBuilder<RandomEngine>::getPlacementCounters() const
     {
-        // If cell not found in zeroDistanceCoordinates cache
-        if (m_zeroDistanceCoordinates.end() ==
-            std::find(m_zeroDistanceCoordinates.begin(), m_zeroDistanceCoordinates.end(), cell))
-        {
-            m_distanceField[cell.y][cell.x] = DISTANCE_FIELD_POTENTIAL_DOOR;
+        return m_result.stats.placement;
+    }
 
-            m_zeroDistanceCoordinates.push_back(cell);
-        }
+    template <typename RandomEngine>
+    const LabyrinthResult& BasicLabyrinthBuilder<RandomEngine>::getResult() const
+    {
+        return m_result;
     }
 
-    void LabyrinthBuilder::setHallwayCell(VectorIntXY cell)
+    template <typename RandomEngine>
+    const DistanceField& BasicLabyrinthBuilder<RandomEngine>::getDistanceField() const
     {
-        // hall overrides potential door. Always set this.
-        m_distanceField[cell.y][cell.x] = DISTANCE_FIELD_HALL;
+        return m_result.distanceField;
+    }
 
-        VectorIntXY coordinate {cell.x, cell.y};
-        if (std::find(m_zeroDistanceCoordinates.begin(), m_zeroDistanceCoordinates.end(), coordinate) == m_zeroDistanceCoordinates.end())
-        {
-            m_zeroDistanceCoordinates.push_back(coordinate);
-        }
+    template <typename RandomEngine>
+    const std::vector<int>& BasicLabyrinthBuilder<RandomEngine>::getRoomTypeCounts() const
+    {
+        return m_roomTypeCounts;
     }
 
-    VectorXY LabyrinthBuilder::nextCoordinateAlongSearchPath(VectorXY currentposition, VectorXY searchDirection)
+    template <typename RandomEngine>
+    RandomEngine BasicLabyrinthBuilder<RandomEngine>::deriveAttemptStream(std::uint64_t randomSeed, std::uint64_t attemptIndex)
     {
-        double nextX, nextY;
+        return deriveStream<RandomEngine>(randomSeed, attemptIndex);
+    }
 
-        if (searchDirection.x > 0)
-        {
-            nextX = currentposition.x + m_cellUnit;
-        }
-        else
-        {
-            nextX = currentposition.x - m_cellUnit;
-        }
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::spawnRooms()
+    {
+        updateRoomTypeSelection(m_numRoomsToSpawn);
 
-        if (searchDirection.y > 0)
-        {
-            nextY = currentposition.y + m_cellUnit;
-        }
-        else
+        RandomEngine firstRoomRandomEngine{ deriveAttemptStream(m_result.randomSeed, m_attemptIndex) };
+        m_attemptIndex++;
+
+        std::optional<std::size_t> firstRoomType{ pickRoomType(firstRoomRandomEngine) };
+        if (!firstRoomType.has_value())
         {
-            nextY = currentposition.y - m_cellUnit;
+            m_result.status = m_isAnyRoomTypeOutOfSpace ? BuildStatus::NoSpaceLeft : BuildStatus::RoomTypesExhausted;
+            return;
         }
 
-        // Use z = mx + b to fill in missing values.
-        // m: slope
-        // b: z such that x = 0
-        double slope = searchDirection.y / searchDirection.x;
-        double yIntercept = currentposition.y - (slope * currentposition.x); // b = z - (m * x)
-        VectorXY targetInterceptX = VectorXY{
-            nextX,
-            (slope * nextX) + yIntercept // y = (m * x) + b
-        };
-        VectorXY targetInterceptZ = VectorXY{
-            (nextY - yIntercept) / slope, // x = (y - b) / m
-            nextY
-        };
-
-        // Choose closest candidate as new currentPosition
-        if (VectorXY::distanceSquared(currentposition, targetInterceptX) < VectorXY::distanceSquared(currentposition, targetInterceptZ))
+        bool isFirstRoomSpawned{};
         {
-            return targetInterceptX;
+            ScopedPhaseTimer firstRoomTimer{ m_result.stats.firstRoomTime };
+            isFirstRoomSpawned = spawnFirstRoom(firstRoomType.value());
         }
-        else
+
+        if (isFirstRoomSpawned && m_distanceFieldUpdateMode != DistanceFieldUpdateMode::Deferred)
         {
-            return targetInterceptZ;
+            recalculateDistanceField();
         }
-    }
 
-    void LabyrinthBuilder::connectToExistingRooms(VectorIntXY roomSpawnCoordinate, const Room& room)
-    {
-        std::vector<PlaneTransform> doors = room.getDoors();
-        if (doors.size() == 0) { throw std::runtime_error{ "Tried to connect a room, but it has no doors!" }; }
+        int numToSpawn{ isFirstRoomSpawned ? m_numRoomsToSpawn - 1 : m_numRoomsToSpawn };
 
-        VectorIntXY minimumDistanceDoor{};
-        int currentMinimumDistance{ std::numeric_limits<int>::max() };
+        // Failed attempts since the last room spawned, and whether a scan since then found space for some room.
+        std::uint64_t consecutiveFailedAttempts{ 0 };
+        bool isSpaceLeft{ false };
+        std::uint64_t spaceScanThreshold{
+            m_placementStrategy == PlacementStrategy::FreeSpaceIndex ? 1 : FAILED_ATTEMPTS_BEFORE_SPACE_SCAN };
 
-        // pick a door to connect based on minimum distance in distance field
-        for (const PlaneTransform& door : doors )
+        while (numToSpawn > 0)
         {
-            VectorIntXY doorCoordinates = findDoorCoordinate(roomSpawnCoordinate, door);
-            int currentDistance{ m_distanceField[doorCoordinates.y][doorCoordinates.x] };
+            // Every attempt picks its room type again, so a type that no longer fits does not stall the search.
+            updateRoomTypeSelection(numToSpawn);
+            if (m_eligibleRoomTypeCount == 0 && m_isAnyRoomTypeOutOfSpace)
+            {
+                m_result.status = BuildStatus::NoSpaceLeft;
+                m_logger.write(LogLevel::Warning, "LabyrinthBuilder has no space left for another room! Stopping early.");
+                break;
+            }
 
-            if (isInDistanceField(doorCoordinates) &&
-                currentDistance < currentMinimumDistance)
+            if (m_eligibleRoomTypeCount == 0)
             {
-                currentMinimumDistance = currentDistance;
-                minimumDistanceDoor = doorCoordinates;
+                m_result.status = BuildStatus::RoomTypesExhausted;
+                m_logger.write(LogLevel::Warning, "LabyrinthBuilder ran out of room types below their maximum count! Stopping early.");
+                break;
             }
-        }
 
-        VectorIntXY currentPathLocation = minimumDistanceDoor;
+            std::size_t candidateCount{ m_placementCandidateCount };
+            evaluatePlacementCandidates(candidateCount);
 
-        std::vector<VectorIntXY> path{};
-        path.push_back(currentPathLocation);
+            // Go through the candidates in attempt order, as a one at a time search would,
+            // until one found space or the search gives up.
+            std::size_t committed{ candidateCount };
+            std::size_t examinedCount{ 0 };
+            while (examinedCount < candidateCount)
+            {
+                const PlacementCandidate& candidate{ m_placementCandidates[examinedCount] };
+                examinedCount++;
 
-        while (m_distanceField[currentPathLocation.y][currentPathLocation.x] > 0)
-        {
-            // look in all directions for minimum distance. set that as new current location.
-            VectorIntXY minimumDistanceCell{};
-            int currentMinimumCellDistance{ std::numeric_limits<int>::max() };
+                if (candidate.isFound)
+                {
+                    committed = examinedCount - 1;
+                    break;
+                }
 
-            for (VectorIntXY direction : m_traversalDirections)
+                m_result.stats.placement.failedAttempts++;
+                consecutiveFailedAttempts++;
+                m_logger.write(LogLevel::Debug, "LabyrinthBuilder could not spawn a room along a search path! Trying a new path.");
+
+                // A few failures in a row hint that the labyrinth may be full. Rather than sampling search paths
+                // until the budget runs out, check every position once. The grid does not change until the next
+                // room spawns, so one scan that finds space holds until then.
+                // The free space index knows exactly where every room type fits, so it checks after the first failure.
+                if (!isSpaceLeft && consecutiveFailedAttempts >= spaceScanThreshold)
+                {
+                    m_result.stats.placement.spaceScans++;
+                    isSpaceLeft = canAnyEligibleRoomTypeFit();
+                    if (!isSpaceLeft)
+                    {
+                        m_result.status = BuildStatus::NoSpaceLeft;
+                        break;
+                    }
+                }
+
+                if (consecutiveFailedAttempts >= m_maxConsecutiveFailedAttempts)
+                {
+                    m_result.status = BuildStatus::PlacementBudgetExhausted;
+                    break;
+                }
+            }
+
+            for (std::size_t i = 0; i < candidateCount; i++)
             {
-                VectorIntXY cellCoord{ currentPathLocation + direction };
-                int cellValue{ m_distanceField[cellCoord.y][cellCoord.x] };
+                m_result.stats.placement.raySteps += m_placementCandidates[i].raySteps;
+            }
 
-                if (cellValue < currentMinimumCellDistance)
+            // Attempts after the last one examined are evaluated again against the updated grid.
+            m_result.stats.placement.attemptsEvaluated += candidateCount;
+            m_result.stats.placement.discardedAttempts += candidateCount - examinedCount;
+            m_attemptIndex += examinedCount;
+
+            if (m_result.status == BuildStatus::NoSpaceLeft)
+            {
+                m_logger.write(LogLevel::Warning, "LabyrinthBuilder has no space left for another room! Stopping early.");
+                break;
+            }
+
+            if (m_result.status == BuildStatus::PlacementBudgetExhausted)
+            {
+                if (m_logger.isEnabled(LogLevel::Warning))
                 {
-                    currentMinimumCellDistance = cellValue;
-                    minimumDistanceCell = cellCoord;
+                    m_logger.write(LogLevel::Warning, "LabyrinthBuilder placement attempts failed " + std::to_string(consecutiveFailedAttempts) + " times in a row! Stopping early.");
                 }
+
+                break;
             }
 
-            currentPathLocation = minimumDistanceCell;
-            path.push_back(currentPathLocation);
-        }
+            if (committed == candidateCount)
+            {
+                continue; // try again
+            }
 
-        for (VectorIntXY cell : path)
-        {
-            if (m_distanceField[cell.y][cell.x] != DISTANCE_FIELD_HALL)
+            numToSpawn--;
+            consecutiveFailedAttempts = 0;
+            isSpaceLeft = false;
+
+            const PlacementCandidate& candidate{ m_placementCandidates[committed] };
+            const RoomTemplate& roomTemplate{ m_roomTypes[candidate.roomType.value()].roomTemplate };
+
+            // With no first room in the centre, the first room placed has nothing to connect to yet.
+            bool isFirstRoom{ m_result.rooms.empty() };
+
+            spawnRoom(candidate.cell, candidate.roomType.value());
+
+            if (!isFirstRoom)
             {
-                // spawn hall floor
-                //var newHall = Instantiate(hallFloorAndCeiling, transform);
-                //newHall.transform.localPosition = unitConverter.CellToMeters(new Vector3(cell.x, 0, cell.z));
+                connectToExistingRooms(candidate.cell, roomTemplate);
+            }
 
-                setHallwayCell(cell);
+            addRoomDoorsToDistanceField(candidate.cell, roomTemplate);
+
+            // Update distance field
+            if (m_distanceFieldUpdateMode != DistanceFieldUpdateMode::Deferred)
+            {
+                recalculateDistanceField();
             }
         }
     }
 
+    /// <summary>
+    /// Evaluate the next count attempts into m_placementCandidates, without changing the grid.
+    /// </summary>
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::evaluatePlacementCandidates(std::size_t count)
+    {
+        ScopedPhaseTimer spawnSearchTimer{ m_result.stats.spawnSearchTime };
 
+        m_placementCandidates.resize(count);
 
-    void LabyrinthBuilder::recalculateDistanceField()
-    {
-        // Check all zero distance coordinates for recalculation of neighbors
-        std::queue<VectorIntXY> toCheck{};
-        for (VectorIntXY coordinate : m_zeroDistanceCoordinates)
+        std::uint64_t firstAttempt{ m_attemptIndex };
+        if (count > 1 && getWorkerPool().getThreadCount() > 1)
+        {
+            getWorkerPool().parallelFor(count, [this, firstAttempt](std::size_t index, std::size_t)
+                {
+                    evaluatePlacementCandidate(firstAttempt + index, m_placementCandidates[index]);
+                });
+        }
+        else
         {
-            toCheck.push(coordinate);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                evaluatePlacementCandidate(firstAttempt + i, m_placementCandidates[i]);
+            }
         }
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::evaluatePlacementCandidate(std::uint64_t attemptIndex, PlacementCandidate& candidate) const
+    {
+        RandomEngine randomEngine{ deriveAttemptStream(m_result.randomSeed, attemptIndex) };
+
+        candidate.roomType = pickRoomType(randomEngine);
+        candidate.isFound = false;
+        candidate.raySteps = 0;
 
-        while (toCheck.size() > 0)
+        if (m_placementStrategy == PlacementStrategy::FreeSpaceIndex)
         {
-            VectorIntXY currentCoordinate{ toCheck.front() };
-            toCheck.pop();
+            std::optional<VectorIntXY> position{
+                m_placementIndexes[m_roomTypePlacementIndexes[candidate.roomType.value()]].pickNearCenter(randomEngine) };
+
+            candidate.isFound = position.has_value();
+            candidate.cell = position.value_or(VectorIntXY{});
+            return;
+        }
 
-            int currentCoordinateDistance = m_distanceField[currentCoordinate.y][currentCoordinate.x];
+        const RoomTemplate& roomTemplate{ m_roomTypes[candidate.roomType.value()].roomTemplate };
 
-            // max(currentCoordinateDistance, 0) to handle sentinel values.
-            if (currentCoordinateDistance < 0) { currentCoordinateDistance = 0; }
+        // Pick a random direction
+        VectorXY direction{
+            randomDouble(randomEngine, -1.0, 1.0),
+            randomDouble(randomEngine, -1.0, 1.0) };
 
-            // Check each direction. If a neighbor cell needs a value, update and queue it. Otherwise move to the next cell.
-            for (VectorIntXY direction : m_traversalDirections)
-            {
-                VectorIntXY cellToCheck = currentCoordinate + direction;
+        // Find an open space.
+        // Start at center and move in the chosen direction looking for enough space for the new room.
+        VectorIntXY center{ m_labyrinthDimensions.x / 2, m_labyrinthDimensions.y / 2 };
+        int roomsizeX = roomTemplate.getFootprint().x;
+        int roomsizeY = roomTemplate.getFootprint().y;
 
-                if (!isInDistanceField(cellToCheck))
-                {
-                    continue;
-                }
+        // Search for open space along the search path until:
+        // 1. we find open space or
+        // 2. we hit the edge.
+        for (GridRay ray{ center, direction }; areRoomExtentsWithinLabyrinth(ray.getCell(), roomsizeX, roomsizeY); ray.step())
+        {
+            candidate.raySteps++;
 
-                if (m_distanceField[cellToCheck.y][cellToCheck.x] != DISTANCE_FIELD_ROOM
-                    && m_distanceField[cellToCheck.y][cellToCheck.x] > currentCoordinateDistance + 1)
-                {
-                    m_distanceField[cellToCheck.y][cellToCheck.x] = currentCoordinateDistance + 1;
-                    toCheck.push(cellToCheck);
-                }
+            // The bitboard tells us whether the footprint overlaps a room, hall or potential door
+            // a word of cells at a time. If it does not, we have found our spawn position.
+            if (m_occupancy.isRectangleOpen(ray.getCell(), VectorIntXY{ roomsizeX, roomsizeY }))
+            {
+                candidate.isFound = true;
+                candidate.cell = ray.getCell();
+                return;
             }
         }
     }
 
-    void LabyrinthBuilder::debugCoutDistanceField()
+    /// <summary>
+    /// Carve a hallway from every boundary door to the nearest hallway or potential door.
+    /// A door that cannot be reached fails the build with BuildStatus::BoundaryDoorUnreachable.
+    /// </summary>
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::connectBoundaryDoors()
     {
-        for (int y = 0; y < m_labyrinthDimensions.y; y++)
+        for (VectorIntXY cell : m_boundaryDoorCells)
         {
-            // print row number
-            std::cout << std::format("{:02}", y);
+            if (!isInDistanceField(cell))
+            {
+                continue;
+            }
 
-            for (int x = 0; x < m_labyrinthDimensions.x; x++)
+            bool isConnected{ false };
+            if (m_distanceFieldUpdateMode == DistanceFieldUpdateMode::Deferred)
+            {
+                m_hallwaySearchStarts.assign(1, cell);
+                isConnected = carveHallwayBySearch(m_hallwaySearchStarts);
+            }
+            else
             {
-                // give ourselvs a visual indication of every 10 columns
-                if (x % 5 == 0)
+                // A cell walled off from every hallway and potential door has no path down the distance field.
+                CellKind kind{ m_result.distanceField.getKind(cell) };
+                bool isWalledOff{
+                    kind == CellKind::Room ||
+                    (kind == CellKind::Open && m_result.distanceField.getDistance(cell) == DistanceField::UNCALCULATED) };
+
+                isConnected = !isWalledOff && carveHallway(cell);
+                if (isConnected)
                 {
-                    std::cout << " | ";
+                    recalculateDistanceField();
                 }
+            }
 
-                int currentCellValue = m_distanceField[y][x];
-
-                if (currentCellValue == DISTANCE_FIELD_ROOM)
-                {
-                    std::cout << "room  ";
-                }
-                else if (currentCellValue == DISTANCE_FIELD_UNCALCULATED)
-                {
-                    std::cout << "....  ";
-                }
-                else if (currentCellValue == DISTANCE_FIELD_HALL)
+            if (!isConnected)
+            {
+                m_result.status = BuildStatus::BoundaryDoorUnreachable;
+                if (m_logger.isEnabled(LogLevel::Warning))
                 {
-                    std::cout << "hall  ";
+                    m_logger.write(LogLevel::Warning, "LabyrinthBuilder could not reach boundary door " + cell.toString() + "!");
                 }
-                else
+            }
+        }
+    }
+
+    /// <summary>
+    /// Spawn the first room in the centre of the labyrinth. Returns false, spawning nothing, if it would cover
+    /// a boundary door or does not fit in the labyrinth, which leaves the first room to the placement search like any other.
+    /// </summary>
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::spawnFirstRoom(std::size_t roomType)
+    {
+        const RoomTemplate& roomTemplate{ m_roomTypes[roomType].roomTemplate };
+        VectorIntXY roomCellDimensions{ roomTemplate.getFootprint() };
+
+        VectorIntXY roomSpawnCell
+        {
+            (m_labyrinthDimensions.x / 2) - (roomCellDimensions.x / 2),
+            (m_labyrinthDimensions.y / 2) - (roomCellDimensions.y / 2)
+        };
+
+        // Only the boundary doors are blocked before the first room spawns.
+        bool isWithinLabyrinth{
+            roomSpawnCell.x >= 0 && roomSpawnCell.y >= 0 &&
+            roomSpawnCell.x + roomCellDimensions.x <= m_labyrinthDimensions.x &&
+            roomSpawnCell.y + roomCellDimensions.y <= m_labyrinthDimensions.y };
+
+        if (!isWithinLabyrinth)
+        {
+            m_logger.write(LogLevel::Debug, "LabyrinthBuilder could not fit the first room in the labyrinth! Searching for a place instead.");
+            return false;
+        }
+
+        if (!m_occupancy.isRectangleOpen(roomSpawnCell, roomCellDimensions))
+        {
+            m_logger.write(LogLevel::Debug, "LabyrinthBuilder could not spawn the first room over a boundary door! Searching for a place instead.");
+            return false;
+        }
+
+        spawnRoom(roomSpawnCell, roomType);
+
+        addRoomDoorsToDistanceField(roomSpawnCell, roomTemplate);
+        return true;
+    }
+
+    /// <summary>
+    /// Spawn a room at the given location, which is the x, y minimum extent of the room.
+    /// </summary>
+    /// <param name="labyrinthCoordinate"></param>
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::spawnRoom(VectorIntXY cell, std::size_t roomType)
+    {
+        const RoomTemplate& roomTemplate{ m_roomTypes[roomType].roomTemplate };
+
+        addRoomToDistanceField(cell, roomTemplate);
+
+        m_result.rooms.push_back(RoomPlacement{ cell, roomTemplate.getFootprint(), roomType });
+        countRoomType(roomType);
+        m_result.stats.placement.roomsPlaced++;
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::addRoomToDistanceField(VectorIntXY cell, const RoomTemplate& roomTemplate)
+    {
+        VectorIntXY roomCellDimensions{ roomTemplate.getFootprint() };
+
+        // Room cells are not passable.
+        m_result.distanceField.setKind(cell, roomCellDimensions, CellKind::Room);
+
+        blockCells(cell, roomCellDimensions);
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::addRoomDoorsToDistanceField(VectorIntXY cell, const RoomTemplate& roomTemplate)
+    {
+        // Mark the space outside each door as a potential door.
+        for (VectorIntXY doorOffset : roomTemplate.getDoorOffsets())
+        {
+            VectorIntXY doorCoordinate{ cell + doorOffset };
+
+            // Make sure we are still in the array and not overriding a room
+            if (!isInDistanceField(doorCoordinate) || m_result.distanceField.getKind(doorCoordinate) == CellKind::Room)
+            {
+                continue;
+            }
+
+            // Make that coordinate 0 in the distance field
+            setPotentialDoorCell(doorCoordinate);
+        }
+    }
+
+    /// <summary>
+    /// Whether the footprint of any room type that can be picked fits anywhere a search path could place it.
+    /// </summary>
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::canAnyEligibleRoomTypeFit() const
+    {
+        for (std::size_t i = 0; i < m_roomTypes.size(); i++)
+        {
+            if (m_eligibleRoomTypeWeights[i] <= 0)
+            {
+                continue;
+            }
+
+            if (m_placementStrategy == PlacementStrategy::FreeSpaceIndex)
+            {
+                if (m_placementIndexes[m_roomTypePlacementIndexes[i]].getOpenCount() > 0)
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            // Search paths keep the cell one past the footprint's maximum corner within the labyrinth too.
+            VectorIntXY footprint{ m_roomTypes[i].roomTemplate.getFootprint() };
+            VectorIntXY maxMinCorner{ m_labyrinthDimensions.x - 1 - footprint.x, m_labyrinthDimensions.y - 1 - footprint.y };
+
+            if (maxMinCorner.x >= 0 && maxMinCorner.y >= 0 && m_occupancy.findOpenRectangle(footprint, maxMinCorner).has_value())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// <summary>
+    /// Open every position of the free space indexes, creating one per distinct room footprint the first time.
+    /// </summary>
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::resetPlacementIndexes()
+    {
+        if (!m_placementIndexes.empty())
+        {
+            for (PlacementIndex& index : m_placementIndexes)
+            {
+                index.reset();
+            }
+
+            return;
+        }
+
+        m_roomTypePlacementIndexes.clear();
+        for (const CompiledRoomType& roomType : m_roomTypes)
+        {
+            VectorIntXY footprint{ roomType.roomTemplate.getFootprint() };
+
+            auto existing{ std::find_if(m_placementIndexes.begin(), m_placementIndexes.end(),
+                [footprint](const PlacementIndex& index) { return index.getFootprint() == footprint; }) };
+
+            if (existing == m_placementIndexes.end())
+            {
+                m_placementIndexes.emplace_back(m_labyrinthDimensions, footprint);
+                existing = m_placementIndexes.end() - 1;
+            }
+
+            m_roomTypePlacementIndexes.push_back(static_cast<std::size_t>(existing - m_placementIndexes.begin()));
+        }
+    }
+
+    /// <summary>
+    /// Bring the set of room types that can be picked up to date with the rooms still to spawn.
+    /// </summary>
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::updateRoomTypeSelection(int roomsRemaining)
+    {
+        if (!m_isFillingMinimums && roomsRemaining <= m_outstandingMinimumCount)
+        {
+            m_isFillingMinimums = true;
+            m_isRoomTypeSelectionDirty = true;
+        }
+
+        // The free space index knows when a type no longer fits anywhere, so it drops out of the pick
+        // instead of spending attempts that cannot succeed.
+        if (!m_isRoomTypeSelectionDirty && m_placementStrategy == PlacementStrategy::FreeSpaceIndex)
+        {
+            for (std::size_t i = 0; i < m_roomTypes.size(); i++)
+            {
+                if (m_eligibleRoomTypeWeights[i] > 0 && !canRoomTypeFit(i))
+                {
+                    m_isRoomTypeSelectionDirty = true;
+                    break;
+                }
+            }
+        }
+
+        if (m_isRoomTypeSelectionDirty)
+        {
+            rebuildRoomTypeSelection();
+        }
+    }
+
+    /// <summary>
+    /// Whether the room type may still fit somewhere. Only the free space index can tell that it does not.
+    /// </summary>
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::canRoomTypeFit(std::size_t roomType) const
+    {
+        return m_placementStrategy != PlacementStrategy::FreeSpaceIndex ||
+            m_placementIndexes[m_roomTypePlacementIndexes[roomType]].getOpenCount() > 0;
+    }
+
+    /// <summary>
+    /// Pick the type of the next room, or nothing if every type has reached its maximum count.
+    /// </summary>
+    template <typename RandomEngine>
+    std::optional<std::size_t> BasicLabyrinthBuilder<RandomEngine>::pickRoomType(RandomEngine& randomEngine) const
+    {
+        if (m_eligibleRoomTypeCount == 0)
+        {
+            return {};
+        }
+
+        // With no choice to make, skip the draw so a single room type builds the same labyrinth it always has.
+        if (m_eligibleRoomTypeCount == 1)
+        {
+            return m_lastEligibleRoomType;
+        }
+
+        return m_roomTypeSelection.sample(randomEngine);
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::rebuildRoomTypeSelection()
+    {
+        m_isRoomTypeSelectionDirty = false;
+        m_eligibleRoomTypeCount = 0;
+        m_isAnyRoomTypeOutOfSpace = false;
+
+        bool hasWeight{ false };
+        for (std::size_t i = 0; i < m_roomTypes.size(); i++)
+        {
+            const CompiledRoomType& roomType{ m_roomTypes[i] };
+            bool isEligible{
+                m_roomTypeCounts[i] < roomType.maxCount &&
+                (!m_isFillingMinimums || m_roomTypeCounts[i] < roomType.minCount) };
+
+            if (isEligible && !canRoomTypeFit(i))
+            {
+                isEligible = false;
+                m_isAnyRoomTypeOutOfSpace = true;
+            }
+
+            m_eligibleRoomTypeWeights[i] = isEligible ? roomType.weight : 0.0;
+            hasWeight = hasWeight || m_eligibleRoomTypeWeights[i] > 0;
+        }
+
+        // Types with no weight only spawn to meet their minimum count, picked evenly when nothing else is left.
+        if (m_isFillingMinimums && !hasWeight)
+        {
+            for (std::size_t i = 0; i < m_roomTypes.size(); i++)
+            {
+                if (m_roomTypeCounts[i] < m_roomTypes[i].minCount && canRoomTypeFit(i))
+                {
+                    m_eligibleRoomTypeWeights[i] = 1.0;
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < m_roomTypes.size(); i++)
+        {
+            if (m_eligibleRoomTypeWeights[i] > 0)
+            {
+                m_eligibleRoomTypeCount++;
+                m_lastEligibleRoomType = i;
+            }
+        }
+
+        if (m_eligibleRoomTypeCount > 1)
+        {
+            m_roomTypeSelection.rebuild(m_eligibleRoomTypeWeights);
+        }
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::countRoomType(std::size_t roomType)
+    {
+        int count{ ++m_roomTypeCounts[roomType] };
+
+        if (count <= m_roomTypes[roomType].minCount)
+        {
+            m_outstandingMinimumCount--;
+        }
+
+        // The set of eligible types only changes when a type reaches one of its limits.
+        if (count == m_roomTypes[roomType].maxCount ||
+            (m_isFillingMinimums && count == m_roomTypes[roomType].minCount))
+        {
+            m_isRoomTypeSelectionDirty = true;
+        }
+    }
+
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::isInDistanceField(VectorIntXY cell) const
+    {
+        return m_result.distanceField.isInBounds(cell);
+    }
+
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::areRoomExtentsWithinLabyrinth(VectorIntXY position, int sizeX, int sizeY) const
+    {
+        return
+            isInDistanceField(position + VectorIntXY{ 0, sizeY }) &&
+            isInDistanceField(position) &&
+            isInDistanceField(position + VectorIntXY{ sizeX, 0 }) &&
+            isInDistanceField(position + VectorIntXY{ sizeX, sizeY });
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::blockCell(VectorIntXY cell)
+    {
+        m_occupancy.setBlocked(cell);
+
+        if (m_placementStrategy == PlacementStrategy::FreeSpaceIndex)
+        {
+            for (PlacementIndex& index : m_placementIndexes)
+            {
+                index.setBlocked(cell);
+            }
+        }
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::blockCells(VectorIntXY min, VectorIntXY size)
+    {
+        m_occupancy.setBlocked(min, size);
+
+        if (m_placementStrategy == PlacementStrategy::FreeSpaceIndex)
+        {
+            for (PlacementIndex& index : m_placementIndexes)
+            {
+                index.setBlocked(min, size);
+            }
+        }
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setPotentialDoorCell(VectorIntXY cell)
+    {
+        // If cell not already a hallway or potential door
+        if (m_result.distanceField.getKind(cell) == CellKind::Open)
+        {
+            m_result.distanceField.setKind(cell, CellKind::PotentialDoor);
+
+            m_zeroDistanceCoordinates.push_back(cell);
+            blockCell(cell);
+        }
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::setHallwayCell(VectorIntXY cell)
+    {
+        CellKind kind{ m_result.distanceField.getKind(cell) };
+        if (kind != CellKind::PotentialDoor && kind != CellKind::Hall)
+        {
+            m_zeroDistanceCoordinates.push_back(cell);
+            blockCell(cell);
+        }
+
+        if (kind != CellKind::Hall)
+        {
+            m_result.hallwayCells.push_back(cell);
+        }
+
+        // hall overrides potential door. Always set this.
+        m_result.distanceField.setKind(cell, CellKind::Hall);
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::connectToExistingRooms(VectorIntXY roomSpawnCoordinate, const RoomTemplate& roomTemplate)
+    {
+        if (roomTemplate.getDoorOffsets().size() == 0) { throw std::runtime_error{ "Tried to connect a room, but it has no doors!" }; }
+
+        if (m_distanceFieldUpdateMode == DistanceFieldUpdateMode::Deferred)
+        {
+            m_hallwaySearchStarts.clear();
+            for (VectorIntXY doorOffset : roomTemplate.getDoorOffsets())
+            {
+                VectorIntXY doorCoordinates{ roomSpawnCoordinate + doorOffset };
+                if (isInDistanceField(doorCoordinates))
+                {
+                    m_hallwaySearchStarts.push_back(doorCoordinates);
+                }
+            }
+
+            if (!carveHallwayBySearch(m_hallwaySearchStarts) && m_logger.isEnabled(LogLevel::Warning))
+            {
+                m_logger.write(LogLevel::Warning, "LabyrinthBuilder could not connect the room at " + roomSpawnCoordinate.toString() + " to any hallway!");
+            }
+
+            return;
+        }
+
+        VectorIntXY minimumDistanceDoor{};
+        std::int64_t currentMinimumDistance{ PATH_ORDER_ROOM };
+
+        // pick a door to connect based on minimum distance in distance field
+        for (VectorIntXY doorOffset : roomTemplate.getDoorOffsets())
+        {
+            VectorIntXY doorCoordinates{ roomSpawnCoordinate + doorOffset };
+
+            // Door coordinates are at most one cell outside the room, so this never reads past the border.
+            std::int64_t currentDistance{ getPathOrder(doorCoordinates) };
+
+            if (isInDistanceField(doorCoordinates) &&
+                currentDistance < currentMinimumDistance)
+            {
+                currentMinimumDistance = currentDistance;
+                minimumDistanceDoor = doorCoordinates;
+            }
+        }
+
+        if (!carveHallway(minimumDistanceDoor) && m_logger.isEnabled(LogLevel::Warning))
+        {
+            m_logger.write(LogLevel::Warning, "LabyrinthBuilder could not connect the room at " + roomSpawnCoordinate.toString() + " to any hallway!");
+        }
+    }
+
+    /// <summary>
+    /// Carve a hallway from the given cell down the distance field to the nearest hallway or potential door.
+    /// The distances were found before the newest room spawned, so its cells can cut the way down. Where no neighbour
+    /// is closer, the hallway is found by searching the grid instead. Returns false, carving nothing, if no hallway or
+    /// potential door can be reached.
+    /// </summary>
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::carveHallway(VectorIntXY start)
+    {
+        ScopedPhaseTimer hallwayCarveTimer{ m_result.stats.hallwayCarveTime };
+
+        VectorIntXY currentPathLocation = start;
+
+        std::vector<VectorIntXY>& path{ m_hallwayPath };
+        path.clear();
+        path.push_back(currentPathLocation);
+
+        std::int64_t currentPathOrder{ getPathOrder(currentPathLocation) };
+        while (currentPathOrder > 0)
+        {
+            // look in all directions for minimum distance. set that as new current location.
+            VectorIntXY minimumDistanceCell{};
+            std::int64_t currentMinimumCellDistance{ PATH_ORDER_ROOM };
+
+            for (VectorIntXY direction : m_traversalDirections)
+            {
+                VectorIntXY cellCoord{ currentPathLocation + direction };
+                std::int64_t cellValue{ getPathOrder(cellCoord) };
+
+                if (cellValue < currentMinimumCellDistance)
+                {
+                    currentMinimumCellDistance = cellValue;
+                    minimumDistanceCell = cellCoord;
+                }
+            }
+
+            if (currentMinimumCellDistance >= currentPathOrder)
+            {
+                m_hallwaySearchStarts.assign(1, start);
+                if (!findHallwayPath(m_hallwaySearchStarts))
+                {
+                    return false;
+                }
+
+                break;
+            }
+
+            currentPathLocation = minimumDistanceCell;
+            currentPathOrder = currentMinimumCellDistance;
+            path.push_back(currentPathLocation);
+        }
+
+        carveHallwayPath();
+        return true;
+    }
+
+    /// <summary>
+    /// Carve a hallway from the nearest of the given cells to the nearest hallway or potential door,
+    /// finding it with a breadth first search instead of the distance field.
+    /// Carves the same hallway carveHallway() would from the start with the lowest distance.
+    /// Returns false, carving nothing, if no start can reach a hallway or potential door.
+    /// </summary>
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::carveHallwayBySearch(const std::vector<VectorIntXY>& starts)
+    {
+        ScopedPhaseTimer hallwayCarveTimer{ m_result.stats.hallwayCarveTime };
+
+        if (!findHallwayPath(starts))
+        {
+            return false;
+        }
+
+        carveHallwayPath();
+        return true;
+    }
+
+    /// <summary>
+    /// Fill m_hallwayPath with the path carveHallwayBySearch() carves.
+    ///
+    /// The search expands from every start at once, a level at a time, and stops after the first level
+    /// that reaches a hallway or potential door, so it only visits cells closer to the starts than the hallway's length.
+    /// A second pass walks back from the hallways and potential doors reached, marking the cells on a shortest path.
+    /// Those are exactly the cells carveHallway() could step to, so picking among them in the same order gives its path.
+    /// </summary>
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::findHallwayPath(const std::vector<VectorIntXY>& starts)
+    {
+        const DistanceField& field{ m_result.distanceField };
+        std::vector<VectorIntXY>& path{ m_hallwayPath };
+        path.clear();
+
+        auto isTarget = [&field](VectorIntXY cell)
+            {
+                CellKind kind{ field.getKind(cell) };
+                return kind == CellKind::Hall || kind == CellKind::PotentialDoor;
+            };
+
+        // A start on a hallway, or else on a potential door, is the whole path.
+        for (CellKind kind : { CellKind::Hall, CellKind::PotentialDoor })
+        {
+            for (VectorIntXY start : starts)
+            {
+                if (field.getKind(start) == kind)
+                {
+                    path.push_back(start);
+                    return true;
+                }
+            }
+        }
+
+        // Each search marks the cells it reaches with a new visit number, and the cells on a shortest path with the one after,
+        // so the marks never need clearing between searches.
+        if (m_hallwaySearchCells.getDimensions() != m_labyrinthDimensions ||
+            m_hallwaySearchVisit > std::numeric_limits<std::uint32_t>::max() - 2)
+        {
+            m_hallwaySearchCells.reset(m_labyrinthDimensions, HallwaySearchCell{}, HallwaySearchCell{});
+            m_hallwaySearchVisit = 0;
+        }
+
+        m_hallwaySearchVisit += 2;
+        const std::uint32_t reached{ m_hallwaySearchVisit };
+        const std::uint32_t onShortestPath{ reached + 1 };
+
+        Grid<HallwaySearchCell>& cells{ m_hallwaySearchCells };
+        std::vector<VectorIntXY>& queue{ m_hallwaySearchQueue };
+        std::vector<VectorIntXY>& targets{ m_hallwaySearchTargets };
+        queue.clear();
+        targets.clear();
+
+        for (VectorIntXY start : starts)
+        {
+            if (field.getKind(start) == CellKind::Open && cells[start].visit != reached)
+            {
+                cells[start] = HallwaySearchCell{ reached, 0 };
+                queue.push_back(start);
+            }
+        }
+
+        // Finish the level that first reaches a hallway or potential door, to find every one at that distance.
+        std::size_t front{ 0 };
+        std::uint32_t distance{ 0 };
+        while (front < queue.size() && targets.empty())
+        {
+            distance++;
+
+            std::size_t levelEnd{ queue.size() };
+            for (; front < levelEnd; front++)
+            {
+                for (VectorIntXY direction : m_traversalDirections)
+                {
+                    VectorIntXY next{ queue[front] + direction };
+
+                    if (isTarget(next))
+                    {
+                        targets.push_back(next);
+                    }
+                    else if (field.getKind(next) == CellKind::Open && cells[next].visit != reached)
+                    {
+                        cells[next] = HallwaySearchCell{ reached, distance };
+                        queue.push_back(next);
+                    }
+                }
+            }
+        }
+
+        if (targets.empty())
+        {
+            return false;
+        }
+
+        // Walk back a level at a time. A cell is on a shortest path if it is one level nearer the starts
+        // than a cell on a shortest path, or than a hallway or potential door found.
+        auto isOnShortestPath = [&field, &cells, onShortestPath](VectorIntXY cell, std::uint32_t depth)
+            {
+                return field.getKind(cell) == CellKind::Open && cells[cell].visit == onShortestPath && cells[cell].depth == depth;
+            };
+
+        auto markPrevious = [&](VectorIntXY cell, std::uint32_t previousDepth)
+            {
+                for (VectorIntXY direction : m_traversalDirections)
+                {
+                    VectorIntXY previous{ cell + direction };
+                    if (field.getKind(previous) == CellKind::Open && cells[previous].visit == reached && cells[previous].depth == previousDepth)
+                    {
+                        cells[previous].visit = onShortestPath;
+                        queue.push_back(previous);
+                    }
+                }
+            };
+
+        queue.clear();
+        for (VectorIntXY target : targets)
+        {
+            markPrevious(target, distance - 1);
+        }
+
+        for (front = 0; front < queue.size(); front++)
+        {
+            std::uint32_t depth{ cells[queue[front]].depth };
+            if (depth > 0)
+            {
+                markPrevious(queue[front], depth - 1);
+            }
+        }
+
+        // Step down the marked cells from the first start on a shortest path, taking the first marked neighbour in traversal order.
+        for (VectorIntXY start : starts)
+        {
+            if (isOnShortestPath(start, 0))
+            {
+                path.push_back(start);
+                break;
+            }
+        }
+
+        for (std::uint32_t depth = 1; depth < distance; depth++)
+        {
+            for (VectorIntXY direction : m_traversalDirections)
+            {
+                VectorIntXY next{ path.back() + direction };
+                if (isOnShortestPath(next, depth))
+                {
+                    path.push_back(next);
+                    break;
+                }
+            }
+        }
+
+        // Then onto a hallway next to the last cell, or else a potential door, as the distance field orders them.
+        for (CellKind kind : { CellKind::Hall, CellKind::PotentialDoor })
+        {
+            for (VectorIntXY direction : m_traversalDirections)
+            {
+                VectorIntXY next{ path.back() + direction };
+                if (field.getKind(next) == kind)
+                {
+                    path.push_back(next);
+                    return true;
+                }
+            }
+        }
+
+        assert(false);
+        return false;
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::carveHallwayPath()
+    {
+        for (VectorIntXY cell : m_hallwayPath)
+        {
+            if (m_result.distanceField.getKind(cell) != CellKind::Hall)
+            {
+                // spawn hall floor
+                //var newHall = Instantiate(hallFloorAndCeiling, transform);
+                //newHall.transform.localPosition = unitConverter.CellToMeters(new Vector3(cell.x, 0, cell.z));
+
+                setHallwayCell(cell);
+            }
+        }
+    }
+
+
+
+    /// <summary>
+    /// Orders cells for hallway carving: hallways first, then potential doors, then open cells by distance.
+    /// Rooms come last.
+    /// </summary>
+    template <typename RandomEngine>
+    std::int64_t BasicLabyrinthBuilder<RandomEngine>::getPathOrder(VectorIntXY cell) const
+    {
+        switch (m_result.distanceField.getKind(cell))
+        {
+        case CellKind::Hall:
+            return -1;
+        case CellKind::PotentialDoor:
+            return 0;
+        case CellKind::Open:
+            return m_result.distanceField.getDistance(cell);
+        default:
+            return PATH_ORDER_ROOM;
+        }
+    }
+
+    template <typename RandomEngine>
+    void BasicLabyrinthBuilder<RandomEngine>::recalculateDistanceField()
+    {
+        ScopedPhaseTimer distanceFieldTimer{ m_result.stats.distanceFieldTime };
+
+        // Distances only ever decrease and every cell lowered by a previous update was propagated then,
+        // so only zero distance coordinates added since the last update can lower any distance.
+        std::size_t firstSeed{ 0 };
+        if (m_distanceFieldUpdateMode == DistanceFieldUpdateMode::Incremental)
+        {
+            firstSeed = m_propagatedZeroDistanceCount;
+        }
+
+        std::size_t visitedCount{};
+        if (m_distanceFieldEngine == DistanceFieldEngine::RasterScan)
+        {
+            visitedCount = m_result.distanceField.propagateRaster();
+        }
+        else if (shouldPropagateDistanceFieldInParallel())
+        {
+            visitedCount = m_result.distanceField.propagateParallel(m_zeroDistanceCoordinates, firstSeed, getWorkerPool());
+        }
+        else
+        {
+            visitedCount = m_result.distanceField.propagate(m_zeroDistanceCoordinates, firstSeed);
+        }
+
+        m_propagatedZeroDistanceCount = m_zeroDistanceCoordinates.size();
+
+        if constexpr (ARE_STATS_ENABLED)
+        {
+            LabyrinthStats& stats{ m_result.stats };
+            stats.distanceFieldCellsVisited += visitedCount;
+
+            // The distance plane only grows during a build, when it widens, so checking after each propagation catches the peak.
+            std::size_t gridBytes{ m_result.distanceField.getMemoryUsage() + m_occupancy.getMemoryUsage() };
+            for (const PlacementIndex& index : m_placementIndexes)
+            {
+                gridBytes += index.getMemoryUsage();
+            }
+
+            stats.peakGridBytes = std::max(stats.peakGridBytes, gridBytes);
+        }
+    }
+
+    template <typename RandomEngine>
+    bool BasicLabyrinthBuilder<RandomEngine>::shouldPropagateDistanceFieldInParallel()
+    {
+        std::size_t cellCount{ static_cast<std::size_t>(m_labyrinthDimensions.x) * static_cast<std::size_t>(m_labyrinthDimensions.y) };
+        if (cellCount < m_parallelDistanceFieldThreshold)
+        {
+            return false;
+        }
+
+        return getWorkerPool().getThreadCount() > 1;
+    }
+
+    template <typename RandomEngine>
+    WorkerPool& BasicLabyrinthBuilder<RandomEngine>::getWorkerPool()
+    {
+        if (!m_workerPool)
+        {
+            m_workerPool = std::make_unique<WorkerPool>(m_distanceFieldThreadCount);
+        }
+
+        return *m_workerPool;
+    }
+
+    template class BasicLabyrinthBuilder<Xoshiro256StarStar>;
+    template class BasicLabyrinthBuilder<std::mt19937_64>;
+
+    namespace
+    {
+        // FNV-1a over every cell's kind and distance.
+        std::uint64_t hashDistanceField(const DistanceField& distanceField)
+        {
+            std::uint64_t hash{ 0xCBF29CE484222325ull };
+            auto addByte = [&hash](std::uint8_t byte)
+            {
+                hash = (hash ^ byte) * 0x100000001B3ull;
+            };
+
+            const VectorIntXY& dimensions{ distanceField.getDimensions() };
+            for (int y = 0; y < dimensions.y; y++)
+            {
+                for (int x = 0; x < dimensions.x; x++)
                 {
-                    std::cout << std::format(" {:02}   ", currentCellValue);
+                    addByte(static_cast<std::uint8_t>(distanceField.getKind(VectorIntXY{ x, y })));
+
+                    std::uint32_t distance{ distanceField.getDistance(VectorIntXY{ x, y }) };
+                    for (int shift = 0; shift < 32; shift += 8)
+                    {
+                        addByte(static_cast<std::uint8_t>(distance >> shift));
+                    }
                 }
             }
 
-            // on to the next row
-            std::cout << "\n";
+            return hash;
         }
     }
 
@@ -515,7 +1423,471 @@ namespace LabyrinthGeneration
             }
         };
 
-        //std::optional<unsigned int> seed{ static_cast<unsigned int>(2269388892) }; // explicit random seed
+        // The random engine and its mappings are fully specified, so a seed gives the same labyrinth on every platform.
+        {
+            LabyrinthBuilder goldenBuilder{ VectorIntXY{40, 40}, 8, 2.0, room, 7u };
+            std::uint64_t goldenHash{ hashDistanceField(goldenBuilder.build().distanceField) };
+            LABYRINTH_CHECK(0xE4339B51DD5D940Cull == goldenHash);
+
+            // Each attempt's stream depends only on the seed and the attempt index.
+            Xoshiro256StarStar attemptStream{ LabyrinthBuilder::deriveAttemptStream(7u, 3) };
+            LABYRINTH_CHECK(attemptStream == LabyrinthBuilder::deriveAttemptStream(7u, 3));
+            LABYRINTH_CHECK(!(attemptStream == LabyrinthBuilder::deriveAttemptStream(7u, 4)));
+
+            // Seeds keep all 64 bits, so seeds that only differ above the low 32 build different labyrinths.
+            LabyrinthBuilder wideSeedBuilder{ VectorIntXY{40, 40}, 8, 2.0, room, 7u + (std::uint64_t{ 1 } << 32) };
+            const LabyrinthResult& wideSeedResult{ wideSeedBuilder.build() };
+            LABYRINTH_CHECK(7u + (std::uint64_t{ 1 } << 32) == wideSeedResult.randomSeed);
+            LABYRINTH_CHECK(goldenHash != hashDistanceField(wideSeedResult.distanceField));
+
+            // Another engine builds its own labyrinths from the same seed, the same way every time.
+            BasicLabyrinthBuilder<std::mt19937_64> otherEngineBuilder{ VectorIntXY{40, 40}, 8, 2.0, room, 7u };
+            std::uint64_t otherEngineHash{ hashDistanceField(otherEngineBuilder.build().distanceField) };
+            LABYRINTH_CHECK(8 == otherEngineBuilder.getResult().rooms.size());
+            LABYRINTH_CHECK(goldenHash != otherEngineHash);
+            LABYRINTH_CHECK(otherEngineHash == hashDistanceField(otherEngineBuilder.build().distanceField));
+        }
+
+        // Incremental distance field updates must match full recalculation.
+        for (unsigned int seed : { 1u, 7u, 2269388892u })
+        {
+            LabyrinthBuilder fullBuilder{ VectorIntXY{40, 40}, 8, 2.0, room, seed };
+            fullBuilder.setDistanceFieldUpdateMode(DistanceFieldUpdateMode::Full);
+            fullBuilder.setLogLevel(LogLevel::None);
+            fullBuilder.build();
+
+            LabyrinthBuilder incrementalBuilder{ VectorIntXY{40, 40}, 8, 2.0, room, seed };
+            incrementalBuilder.setDistanceFieldUpdateMode(DistanceFieldUpdateMode::Incremental);
+            incrementalBuilder.setLogLevel(LogLevel::None);
+            incrementalBuilder.build();
+
+            // Building again must start from a clean slate.
+            incrementalBuilder.build();
+
+            LABYRINTH_CHECK(fullBuilder.getDistanceField() == incrementalBuilder.getDistanceField());
+        }
+
+        // The occupancy bitboard blocks exactly the cells that are not open.
+        {
+            LabyrinthBuilder occupancyBuilder{ VectorIntXY{ 130, 70 }, 40, 2.0, room, 5u };
+            occupancyBuilder.setLogLevel(LogLevel::None);
+            const DistanceField& field{ occupancyBuilder.build().distanceField };
+            const OccupancyBitboard& occupancy{ occupancyBuilder.getOccupancy() };
+
+            LABYRINTH_CHECK(field.getDimensions() == occupancy.getDimensions());
+            for (int y = 0; y < field.getDimensions().y; y++)
+            {
+                for (int x = 0; x < field.getDimensions().x; x++)
+                {
+                    VectorIntXY cell{ x, y };
+                    LABYRINTH_CHECK((field.getKind(cell) != CellKind::Open) == occupancy.isBlocked(cell));
+                }
+            }
+        }
+
+        // Raster sweeps must match the BFS.
+        for (unsigned int seed : { 1u, 7u, 2269388892u })
+        {
+            VectorIntXY dimensions{ seed == 7u ? VectorIntXY{ 400, 300 } : VectorIntXY{ 40, 40 } };
+            int roomCount{ seed == 7u ? 30 : 8 };
+
+            LabyrinthBuilder searchBuilder{ dimensions, roomCount, 2.0, room, seed };
+            searchBuilder.setLogLevel(LogLevel::None);
+            searchBuilder.build();
+
+            LabyrinthBuilder rasterBuilder{ dimensions, roomCount, 2.0, room, seed };
+            rasterBuilder.setDistanceFieldEngine(DistanceFieldEngine::RasterScan);
+            rasterBuilder.setLogLevel(LogLevel::None);
+            rasterBuilder.build();
+
+            LABYRINTH_CHECK(searchBuilder.getResult() == rasterBuilder.getResult());
+        }
+
+        // Routing each hallway with a search from the new room's doors carves the same hallways as descending
+        // the distance field, on open and crowded grids and with boundary doors to connect.
+        for (unsigned int seed : { 1u, 7u, 13u, 2269388892u })
+        {
+            VectorIntXY dimensions{ seed == 13u ? VectorIntXY{ 64, 64 } : VectorIntXY{ 90, 70 } };
+            int roomCount{ seed == 13u ? 150 : 20 };
+            std::vector<VectorIntXY> boundaryDoorCells{ { 0, 20 }, { dimensions.x - 1, 5 }, { 17, dimensions.y - 1 } };
+
+            LabyrinthBuilder fieldBuilder{ dimensions, roomCount, 2.0, room, seed };
+            fieldBuilder.setLogLevel(LogLevel::None);
+            fieldBuilder.setBoundaryDoorCells(boundaryDoorCells);
+            fieldBuilder.build();
+
+            LabyrinthBuilder searchBuilder{ dimensions, roomCount, 2.0, room, seed };
+            searchBuilder.setLogLevel(LogLevel::None);
+            searchBuilder.setBoundaryDoorCells(boundaryDoorCells);
+            searchBuilder.setDistanceFieldUpdateMode(DistanceFieldUpdateMode::Deferred);
+            searchBuilder.build();
+
+            LABYRINTH_CHECK(fieldBuilder.getResult() == searchBuilder.getResult());
+            LABYRINTH_CHECK(BuildStatus::BoundaryDoorUnreachable != fieldBuilder.getResult().status);
+
+            // The field is only propagated once, so the search mode visits fewer distance field cells.
+            if constexpr (ARE_STATS_ENABLED)
+            {
+                LABYRINTH_CHECK(searchBuilder.getResult().stats.distanceFieldCellsVisited < fieldBuilder.getResult().stats.distanceFieldCellsVisited);
+            }
+        }
+
+        // The first room never covers a boundary door, and a door no hallway can reach fails the build.
+        {
+            LabyrinthBuilder centreDoorBuilder{ VectorIntXY{ 20, 20 }, 4, 2.0, room, 5u };
+            centreDoorBuilder.setLogLevel(LogLevel::None);
+            centreDoorBuilder.setBoundaryDoorCells({ VectorIntXY{ 10, 10 } });
+            const LabyrinthResult& result{ centreDoorBuilder.build() };
+
+            LABYRINTH_CHECK(CellKind::Hall == result.distanceField.getKind(VectorIntXY{ 10, 10 }));
+            LABYRINTH_CHECK(BuildStatus::Complete == result.status);
+            LABYRINTH_CHECK(4 == result.rooms.size());
+
+            // Its doors lead out of the labyrinth, so nothing on the top row can reach a hallway.
+            Room wideRoom
+            {
+                Vector3{10, 6, 3},
+                {
+                    PlaneTransform{ Vector3{0, 3, 0}, VectorXY{-1, 0} },
+                    PlaneTransform{ Vector3{10, 3, 0}, VectorXY{1, 0} },
+                }
+            };
+
+            for (DistanceFieldUpdateMode mode : { DistanceFieldUpdateMode::Incremental, DistanceFieldUpdateMode::Deferred })
+            {
+                LabyrinthBuilder walledBuilder{ VectorIntXY{ 5, 5 }, 1, 2.0, wideRoom, 5u };
+                walledBuilder.setLogLevel(LogLevel::None);
+                walledBuilder.setDistanceFieldUpdateMode(mode);
+                walledBuilder.setBoundaryDoorCells({ VectorIntXY{ 2, 0 } });
+                LABYRINTH_CHECK(BuildStatus::BoundaryDoorUnreachable == walledBuilder.build().status);
+            }
+
+            // A first room larger than the labyrinth is left to the search, which finds no space for it
+            // instead of stamping it outside the grid.
+            for (PlacementStrategy strategy : { PlacementStrategy::SearchRay, PlacementStrategy::FreeSpaceIndex })
+            {
+                LabyrinthBuilder oversizedBuilder{ VectorIntXY{ 4, 4 }, 1, 2.0, wideRoom, 5u };
+                oversizedBuilder.setLogLevel(LogLevel::None);
+                oversizedBuilder.setPlacementStrategy(strategy);
+                const LabyrinthResult& oversizedResult{ oversizedBuilder.build() };
+
+                LABYRINTH_CHECK(BuildStatus::NoSpaceLeft == oversizedResult.status);
+                LABYRINTH_CHECK(oversizedResult.rooms.empty());
+                for (int y = 0; y < 4; y++)
+                {
+                    for (int x = 0; x < 4; x++)
+                    {
+                        LABYRINTH_CHECK(CellKind::Open == oversizedResult.distanceField.getKind(VectorIntXY{ x, y }));
+                    }
+                }
+            }
+        }
+
+        // Parallel distance field propagation must match the serial BFS.
+        for (unsigned int seed : { 3u, 11u })
+        {
+            LabyrinthBuilder serialBuilder{ VectorIntXY{400, 300}, 30, 2.0, room, seed };
+            serialBuilder.setLogLevel(LogLevel::None);
+            serialBuilder.setDistanceFieldThreadCount(1);
+            serialBuilder.build();
+
+            LabyrinthBuilder parallelBuilder{ VectorIntXY{400, 300}, 30, 2.0, room, seed };
+            parallelBuilder.setLogLevel(LogLevel::None);
+            parallelBuilder.setParallelDistanceFieldThreshold(0);
+            parallelBuilder.setDistanceFieldThreadCount(4);
+            parallelBuilder.build();
+
+            LABYRINTH_CHECK(serialBuilder.getDistanceField() == parallelBuilder.getDistanceField());
+        }
+
+        // Evaluating several placement attempts at once commits the same rooms as trying them one by one.
+        // The crowded grid makes later rooms fail attempts before they find space.
+        for (VectorIntXY dimensions : { VectorIntXY{ 64, 64 }, VectorIntXY{ 400, 300 } })
+        {
+            int roomCount{ dimensions.x == 64 ? 150 : 60 };
+
+            LabyrinthBuilder serialBuilder{ dimensions, roomCount, 2.0, room, 13u };
+            serialBuilder.setLogLevel(LogLevel::None);
+            serialBuilder.build();
+
+            LabyrinthBuilder batchedBuilder{ dimensions, roomCount, 2.0, room, 13u };
+            batchedBuilder.setLogLevel(LogLevel::None);
+            batchedBuilder.setDistanceFieldThreadCount(4);
+            batchedBuilder.setPlacementCandidateCount(8);
+            batchedBuilder.build();
+
+            LABYRINTH_CHECK(serialBuilder.getResult() == batchedBuilder.getResult());
+
+            const PlacementCounters& serialCounters{ serialBuilder.getPlacementCounters() };
+            const PlacementCounters& batchedCounters{ batchedBuilder.getPlacementCounters() };
+            LABYRINTH_CHECK(serialCounters.roomsPlaced == batchedCounters.roomsPlaced);
+            LABYRINTH_CHECK(serialCounters.failedAttempts == batchedCounters.failedAttempts);
+            LABYRINTH_CHECK(0 == serialCounters.discardedAttempts);
+            LABYRINTH_CHECK(dimensions.x != 64 || serialCounters.failedAttempts > 0);
+
+            for (const PlacementCounters& counters : { serialCounters, batchedCounters })
+            {
+                LABYRINTH_CHECK(counters.attemptsEvaluated == counters.failedAttempts + counters.discardedAttempts + counters.roomsPlaced - 1);
+            }
+        }
+
+        // Asking for more rooms than fit stops once no room fits anywhere, instead of searching forever.
+        {
+            LabyrinthBuilder fullBuilder{ VectorIntXY{ 24, 24 }, 100, 2.0, room, 3u };
+            fullBuilder.setLogLevel(LogLevel::None);
+            const LabyrinthResult& result{ fullBuilder.build() };
+
+            LABYRINTH_CHECK(BuildStatus::NoSpaceLeft == result.status);
+            LABYRINTH_CHECK(result.rooms.size() < 100);
+            LABYRINTH_CHECK(fullBuilder.getPlacementCounters().spaceScans > 0);
+
+            // Batched placement stops at the same attempt.
+            LabyrinthBuilder batchedBuilder{ VectorIntXY{ 24, 24 }, 100, 2.0, room, 3u };
+            batchedBuilder.setLogLevel(LogLevel::None);
+            batchedBuilder.setPlacementCandidateCount(8);
+            LABYRINTH_CHECK(result == batchedBuilder.build());
+            LABYRINTH_CHECK(BuildStatus::NoSpaceLeft == batchedBuilder.getResult().status);
+            LABYRINTH_CHECK(fullBuilder.getPlacementCounters().failedAttempts == batchedBuilder.getPlacementCounters().failedAttempts);
+
+            // The placement budget gives up sooner, with the rooms placed so far.
+            LabyrinthBuilder budgetBuilder{ VectorIntXY{ 64, 64 }, 150, 2.0, room, 13u };
+            budgetBuilder.setLogLevel(LogLevel::None);
+            budgetBuilder.setMaxConsecutiveFailedAttempts(1);
+            const LabyrinthResult& budgetResult{ budgetBuilder.build() };
+
+            LABYRINTH_CHECK(BuildStatus::PlacementBudgetExhausted == budgetResult.status);
+            LABYRINTH_CHECK(1 == budgetBuilder.getPlacementCounters().failedAttempts);
+            LABYRINTH_CHECK(budgetResult.rooms.size() < 150);
+
+            // Room counts that fit build completely.
+            LabyrinthBuilder completeBuilder{ VectorIntXY{ 40, 40 }, 8, 2.0, room, 7u };
+            LABYRINTH_CHECK(BuildStatus::Complete == completeBuilder.build().status);
+        }
+
+        // The free space index places rooms only where they fit, and stops before spending an attempt
+        // once no room fits anywhere.
+        {
+            LabyrinthBuilder indexBuilder{ VectorIntXY{ 64, 64 }, 400, 2.0, room, 13u };
+            indexBuilder.setLogLevel(LogLevel::None);
+            indexBuilder.setPlacementStrategy(PlacementStrategy::FreeSpaceIndex);
+            const LabyrinthResult& result{ indexBuilder.build() };
+
+            LABYRINTH_CHECK(BuildStatus::NoSpaceLeft == result.status);
+            LABYRINTH_CHECK(0 == indexBuilder.getPlacementCounters().failedAttempts);
+            LABYRINTH_CHECK(0 == indexBuilder.getPlacementCounters().spaceScans);
+
+            std::size_t roomCellCount{ 0 };
+            for (const RoomPlacement& placement : result.rooms)
+            {
+                roomCellCount += static_cast<std::size_t>(placement.size.x * placement.size.y);
+            }
+
+            std::size_t fieldRoomCellCount{ 0 };
+            for (int y = 0; y < 64; y++)
+            {
+                for (int x = 0; x < 64; x++)
+                {
+                    fieldRoomCellCount += result.distanceField.getKind(VectorIntXY{ x, y }) == CellKind::Room;
+                }
+            }
+            LABYRINTH_CHECK(roomCellCount == fieldRoomCellCount);
+
+            // Search rays on the same grid give up with fewer rooms placed.
+            LabyrinthBuilder rayBuilder{ VectorIntXY{ 64, 64 }, 400, 2.0, room, 13u };
+            rayBuilder.setLogLevel(LogLevel::None);
+            LABYRINTH_CHECK(rayBuilder.build().rooms.size() < result.rooms.size());
+
+            // No position a search ray could reach is left open.
+            const OccupancyBitboard& occupancy{ indexBuilder.getOccupancy() };
+            for (int y = 0; y <= 64 - 1 - 3; y++)
+            {
+                for (int x = 0; x <= 64 - 1 - 3; x++)
+                {
+                    LABYRINTH_CHECK(!occupancy.isRectangleOpen(VectorIntXY{ x, y }, VectorIntXY{ 3, 3 }));
+                }
+            }
+
+            // Placement does not depend on the distance field, batching or building again.
+            LabyrinthBuilder deferredBuilder{ VectorIntXY{ 64, 64 }, 400, 2.0, room, 13u };
+            deferredBuilder.setLogLevel(LogLevel::None);
+            deferredBuilder.setPlacementStrategy(PlacementStrategy::FreeSpaceIndex);
+            deferredBuilder.setDistanceFieldUpdateMode(DistanceFieldUpdateMode::Deferred);
+            deferredBuilder.setPlacementCandidateCount(8);
+            deferredBuilder.build();
+            LABYRINTH_CHECK(result == deferredBuilder.getResult());
+
+            indexBuilder.build();
+            LABYRINTH_CHECK(indexBuilder.getResult() == deferredBuilder.getResult());
+
+            // A type that fits nowhere drops out of the pick, and the build goes on with the types that still fit.
+            Room largeRoom
+            {
+                Vector3{20, 20, 3},
+                {
+                    PlaneTransform{ Vector3{10, 0, 0}, VectorXY{0, -1} },
+                    PlaneTransform{ Vector3{10, 20, 0}, VectorXY{0, 1} },
+                }
+            };
+
+            LabyrinthBuilder mixedBuilder{ VectorIntXY{ 64, 64 }, 400, 2.0, { RoomType{ largeRoom, 100.0 }, RoomType{ room, 1.0 } }, 13u };
+            mixedBuilder.setLogLevel(LogLevel::None);
+            mixedBuilder.setPlacementStrategy(PlacementStrategy::FreeSpaceIndex);
+            mixedBuilder.setMaxConsecutiveFailedAttempts(1);
+            mixedBuilder.build();
+
+            LABYRINTH_CHECK(BuildStatus::NoSpaceLeft == mixedBuilder.getResult().status);
+            LABYRINTH_CHECK(0 == mixedBuilder.getPlacementCounters().failedAttempts);
+            LABYRINTH_CHECK(mixedBuilder.getRoomTypeCounts()[0] > 0);
+            LABYRINTH_CHECK(mixedBuilder.getRoomTypeCounts()[1] > 0);
+        }
+
+        // Once warmed up, building again reuses every scratch buffer and allocates nothing.
+        {
+            LabyrinthBuilder reusedBuilder{ VectorIntXY{60, 60}, 12, 2.0, room, 5u };
+            reusedBuilder.setLogLevel(LogLevel::None);
+            reusedBuilder.build();
+
+            std::uint64_t allocationsBefore{ getThreadAllocationCount() };
+            reusedBuilder.build();
+            reusedBuilder.build();
+            LABYRINTH_CHECK(allocationsBefore == getThreadAllocationCount());
+
+            // Hallway searches keep their scratch buffers too.
+            reusedBuilder.setDistanceFieldUpdateMode(DistanceFieldUpdateMode::Deferred);
+            reusedBuilder.build();
+
+            allocationsBefore = getThreadAllocationCount();
+            reusedBuilder.build();
+            LABYRINTH_CHECK(allocationsBefore == getThreadAllocationCount());
+
+            // So do the free space indexes.
+            reusedBuilder.setPlacementStrategy(PlacementStrategy::FreeSpaceIndex);
+            reusedBuilder.build();
+
+            allocationsBefore = getThreadAllocationCount();
+            reusedBuilder.build();
+            LABYRINTH_CHECK(allocationsBefore == getThreadAllocationCount());
+
+            // Messages are only built for enabled levels, so stopping early allocates nothing either.
+            LabyrinthBuilder budgetBuilder{ VectorIntXY{ 64, 64 }, 150, 2.0, room, 13u };
+            budgetBuilder.setLogLevel(LogLevel::None);
+            budgetBuilder.setMaxConsecutiveFailedAttempts(1);
+            budgetBuilder.build();
+
+            allocationsBefore = getThreadAllocationCount();
+            LABYRINTH_CHECK(BuildStatus::PlacementBudgetExhausted == budgetBuilder.build().status);
+            LABYRINTH_CHECK(allocationsBefore == getThreadAllocationCount());
+        }
+
+        // Room types respect their minimum and maximum counts.
+        {
+            Room smallRoom
+            {
+                Vector3{4, 4, 3},
+                {
+                    PlaneTransform{ Vector3{2, 0, 0}, VectorXY{0, -1} },
+                    PlaneTransform{ Vector3{2, 4, 0}, VectorXY{0, 1} },
+                    PlaneTransform{ Vector3{0, 2, 0}, VectorXY{-1, 0} },
+                    PlaneTransform{ Vector3{4, 2, 0}, VectorXY{1, 0} },
+                }
+            };
+
+            std::vector<RoomType> roomTypes{
+                RoomType{ room, 3.0, 0, 4 },
+                RoomType{ smallRoom, 1.0, 6 },
+                RoomType{ smallRoom, 0.0, 2 },
+            };
+
+            LabyrinthBuilder typedBuilder{ VectorIntXY{80, 80}, 20, 2.0, roomTypes, 9u };
+            typedBuilder.setLogLevel(LogLevel::None);
+            typedBuilder.build();
+
+            std::vector<int> counts{ typedBuilder.getRoomTypeCounts() };
+            LABYRINTH_CHECK(20 == counts[0] + counts[1] + counts[2]);
+            LABYRINTH_CHECK(counts[0] <= 4);
+            LABYRINTH_CHECK(counts[1] >= 6);
+            LABYRINTH_CHECK(2 == counts[2]);
+
+            // The same seed picks the same types.
+            typedBuilder.build();
+            LABYRINTH_CHECK(counts == typedBuilder.getRoomTypeCounts());
+
+            // Once every type is at its maximum count, no more rooms spawn.
+            LabyrinthBuilder cappedBuilder{ VectorIntXY{80, 80}, 20, 2.0, { RoomType{ room, 1.0, 0, 3 }, RoomType{ smallRoom, 1.0, 0, 2 } }, 9u };
+            cappedBuilder.setLogLevel(LogLevel::None);
+            cappedBuilder.build();
+            LABYRINTH_CHECK((std::vector<int>{ 3, 2 }) == cappedBuilder.getRoomTypeCounts());
+            LABYRINTH_CHECK(BuildStatus::RoomTypesExhausted == cappedBuilder.getResult().status);
+        }
+
+        // The result lists every room and hallway cell the build placed.
+        {
+            LabyrinthBuilder resultBuilder{ VectorIntXY{40, 40}, 8, 2.0, room, 7u };
+            const LabyrinthResult& result{ resultBuilder.build() };
+
+            LABYRINTH_CHECK(7u == result.randomSeed);
+            LABYRINTH_CHECK(8 == result.rooms.size());
+            LABYRINTH_CHECK(!result.hallwayCells.empty());
+
+            for (const RoomPlacement& placement : result.rooms)
+            {
+                LABYRINTH_CHECK(VectorIntXY(3, 3) == placement.size);
+                LABYRINTH_CHECK(0 == placement.roomType);
+                LABYRINTH_CHECK(CellKind::Room == result.distanceField.getKind(placement.min));
+            }
+
+            for (VectorIntXY cell : result.hallwayCells)
+            {
+                LABYRINTH_CHECK(CellKind::Hall == result.distanceField.getKind(cell));
+            }
+
+            std::size_t hallwayCellCount{ 0 };
+            for (int y = 0; y < 40; y++)
+            {
+                for (int x = 0; x < 40; x++)
+                {
+                    hallwayCellCount += result.distanceField.getKind(VectorIntXY{ x, y }) == CellKind::Hall;
+                }
+            }
+            LABYRINTH_CHECK(hallwayCellCount == result.hallwayCells.size());
+
+            // Statistics account for the work the build did.
+            const LabyrinthStats& stats{ result.stats };
+            LABYRINTH_CHECK(8 == stats.placement.roomsPlaced);
+            if constexpr (ARE_STATS_ENABLED)
+            {
+                LABYRINTH_CHECK(result.hallwayCells.size() == stats.hallwayLength);
+                LABYRINTH_CHECK(stats.distanceFieldCellsVisited > 0);
+                LABYRINTH_CHECK(stats.peakGridBytes >= result.distanceField.getMemoryUsage());
+                LABYRINTH_CHECK(stats.totalTime >= stats.firstRoomTime + stats.spawnSearchTime + stats.hallwayCarveTime + stats.distanceFieldTime);
+            }
+
+            // Diagnostics go to the sink, filtered by level. The crowded grid fails attempts and runs out of space.
+            std::vector<std::size_t> messageCounts(4);
+            LabyrinthBuilder loggedBuilder{ VectorIntXY{ 24, 24 }, 100, 2.0, room, 3u };
+            loggedBuilder.setLogSink([&messageCounts](LogLevel level, std::string_view) { messageCounts[static_cast<std::size_t>(level)]++; });
+
+            loggedBuilder.setLogLevel(LogLevel::Warning);
+            loggedBuilder.build();
+            LABYRINTH_CHECK((std::vector<std::size_t>{ 0, 1, 0, 0 }) == messageCounts);
+
+            std::fill(messageCounts.begin(), messageCounts.end(), 0);
+            loggedBuilder.setLogLevel(LogLevel::Debug);
+            loggedBuilder.build();
+            LABYRINTH_CHECK(1 == messageCounts[static_cast<std::size_t>(LogLevel::Warning)]);
+            LABYRINTH_CHECK(0 == messageCounts[static_cast<std::size_t>(LogLevel::Info)]);
+            LABYRINTH_CHECK(loggedBuilder.getPlacementCounters().failedAttempts == messageCounts[static_cast<std::size_t>(LogLevel::Debug)]);
+
+            // Without a seed, the seed picked from the clock is reported at the info level, whatever else the build logs.
+            std::fill(messageCounts.begin(), messageCounts.end(), 0);
+            loggedBuilder.setRandomSeed({});
+            loggedBuilder.setLogLevel(LogLevel::Info);
+            loggedBuilder.build();
+            LABYRINTH_CHECK(1 == messageCounts[static_cast<std::size_t>(LogLevel::Info)]);
+            LABYRINTH_CHECK(0 == messageCounts[static_cast<std::size_t>(LogLevel::Debug)]);
+        }
+
+        //std::optional<std::uint64_t> seed{ 2269388892 }; // explicit random seed
 
         LabyrinthBuilder builder{
             VectorIntXY{40, 40},
@@ -524,7 +1896,11 @@ namespace LabyrinthGeneration
             room,
             //seed
         };
-        
-        builder.build();
+
+        builder.setLogLevel(LogLevel::Info);
+        builder.setLogSink([](LogLevel, std::string_view message) { std::cout << message << "\n"; });
+
+        TextRenderer renderer{};
+        renderer.render(builder.build().distanceField, std::cout);
     }
 }
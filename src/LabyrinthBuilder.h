@@ -1,29 +1,105 @@
 #pragma once
 
+#include "AliasTable.h"
 #include "CellUnitConverter.h"
+#include "DistanceField.h"
+#include "Grid.h"
+#include "LabyrinthResult.h"
+#include "Logging.h"
+#include "OccupancyBitboard.h"
+#include "PlacementIndex.h"
+#include "Random.h"
 #include "Room.h"
+#include "RoomTemplate.h"
 #include "VectorIntXY.h"
+#include "WorkerPool.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <random>
 #include <vector>
 
 namespace LabyrinthGeneration
 {
+    /// <summary>
+    /// How the distance field is brought up to date after a room is added.
+    /// Every mode produces the same labyrinth and distance field.
+    /// </summary>
+    enum class DistanceFieldUpdateMode
+    {
+        // Propagate from every hallway and potential door cell.
+        Full,
+
+        // Propagate only from the hallway and potential door cells added since the last update.
+        Incremental,
+
+        // Propagate once, when every hallway is carved. Each room's hallway is found with a search from its doors
+        // that stops at the nearest hallway or potential door, so it costs the area within the hallway's length
+        // rather than the whole grid.
+        Deferred
+    };
+
+    /// <summary>
+    /// How the distance field is propagated. Both engines produce the same distance field.
+    /// </summary>
+    enum class DistanceFieldEngine
+    {
+        // Breadth first search from the hallway and potential door cells, following the update mode
+        // and spread over several threads on large grids.
+        BreadthFirst,
+
+        // Raster sweeps over the whole grid on one thread. Costs every cell per update whatever the update mode,
+        // but streams through memory instead of following a queue.
+        RasterScan
+    };
+
+    /// <summary>
+    /// How the builder finds a position for each room after the first.
+    /// </summary>
+    enum class PlacementStrategy
+    {
+        // Walk a ray from the centre in a random direction and take the first position along it where the room fits.
+        // Cheap on open grids, but an attempt can fail on a crowded grid even when the room fits elsewhere.
+        SearchRay,
+
+        // Keep every position where each room footprint fits, updated as cells are blocked, and pick one of them
+        // in the ring nearest the centre. An attempt only fails when its room type fits nowhere.
+        FreeSpaceIndex
+    };
+
+    /// <summary>
+    /// A room the builder can spawn, how often it is picked relative to the other room types,
+    /// and how many times it must and may appear in one labyrinth.
+    /// </summary>
+    struct RoomType
+    {
+        Room room;
+        double weight{ 1 };
+        int minCount{ 0 };
+        int maxCount{ std::numeric_limits<int>::max() };
+    };
+
     /// <summary>
     /// Class to build a labyrinth out of rooms, doors, and hallway assets.
+    ///
+    /// RandomEngine makes every random choice of a build. It must produce uniformly distributed 64 bit values
+    /// and be constructible from a 64 bit seed. LabyrinthBuilder.cpp instantiates the builder for Xoshiro256StarStar,
+    /// the default, and for std::mt19937_64. Another engine needs its own instantiation there.
     /// </summary>
-    class LabyrinthBuilder
+    template <typename RandomEngine = Xoshiro256StarStar>
+    class BasicLabyrinthBuilder
     {
-        // Sentinel values for the distance field
-        static const int DISTANCE_FIELD_ROOM{ std::numeric_limits<int>::max() };
-        static const int DISTANCE_FIELD_UNCALCULATED{ std::numeric_limits<int>::max() - 1 };
-        static const int DISTANCE_FIELD_POTENTIAL_DOOR{ 0 };
-        static const int DISTANCE_FIELD_HALL{ std::numeric_limits<int>::min() };
+        // Path order of room cells. Orders after every other cell.
+        static constexpr std::int64_t PATH_ORDER_ROOM{ std::int64_t{ DistanceField::UNCALCULATED } + 1 };
 
-        std::optional<int> m_randomSeed{};
+        // Failed placement attempts in a row before checking whether any room fits at all.
+        static constexpr std::uint64_t FAILED_ATTEMPTS_BEFORE_SPACE_SCAN{ 8 };
+
+        std::optional<std::uint64_t> m_randomSeed{};
 
         VectorIntXY m_labyrinthDimensions{1, 1};
         int m_numRoomsToSpawn{};
@@ -32,51 +108,293 @@ namespace LabyrinthGeneration
         // This value represents the world space dimension of one side of a cell.
         double m_cellUnit{ 1 };
 
-        std::vector<std::vector<int>> m_distanceField;
+        // Reused by every call to build().
+        LabyrinthResult m_result{};
+
+        // A room type with its room already converted to cell space.
+        struct CompiledRoomType
+        {
+            RoomTemplate roomTemplate;
+            double weight;
+            int minCount;
+            int maxCount;
+        };
+
+        // Converted once when the builder is created, so placing a room never converts it again.
+        std::vector<CompiledRoomType> m_roomTypes;
+
+        // Rooms of each type spawned by the current build.
+        std::vector<int> m_roomTypeCounts{};
+
+        // Rooms still needed to bring every type up to its minimum count.
+        int m_outstandingMinimumCount{};
+
+        // Set once the remaining rooms are all needed to meet minimum counts.
+        // From then on only types below their minimum are picked.
+        bool m_isFillingMinimums{ false };
+
+        // Picks among the types that can currently be spawned. Only rebuilt when that set changes.
+        AliasTable m_roomTypeSelection{};
+        std::vector<double> m_eligibleRoomTypeWeights{};
+        std::size_t m_eligibleRoomTypeCount{};
+        std::size_t m_lastEligibleRoomType{};
+        bool m_isRoomTypeSelectionDirty{ true };
 
-        Room m_room;
+        // Set when a type that could otherwise be picked was left out because it fits nowhere.
+        bool m_isAnyRoomTypeOutOfSpace{ false };
 
         CellUnitConverter m_converter;
 
+        // Ordered list of hallway and potential door cells. Seeds the distance field updates.
+        // Membership is checked through the cell kind in the distance field.
         std::vector<VectorIntXY> m_zeroDistanceCoordinates{};
 
+        // Cells a new room cannot overlap: room cells plus hallway and potential door cells.
+        // Search rays test footprints against it, and the check for space left scans it.
+        OccupancyBitboard m_occupancy;
+
+        PlacementStrategy m_placementStrategy{ PlacementStrategy::SearchRay };
+
+        // Positions where each distinct room footprint fits, for the free space index strategy.
+        // Created by the first build that uses them and reset by later ones.
+        std::vector<PlacementIndex> m_placementIndexes{};
+
+        // Which of m_placementIndexes each room type uses.
+        std::vector<std::size_t> m_roomTypePlacementIndexes{};
+
+        // Number of m_zeroDistanceCoordinates entries that have already been propagated through the distance field.
+        std::size_t m_propagatedZeroDistanceCount{};
+
+        DistanceFieldUpdateMode m_distanceFieldUpdateMode{ DistanceFieldUpdateMode::Incremental };
+        DistanceFieldEngine m_distanceFieldEngine{ DistanceFieldEngine::BreadthFirst };
+
+        // Grids with at least this many cells propagate the distance field on several threads.
+        std::size_t m_parallelDistanceFieldThreshold{ 1 << 20 };
+
+        // Zero uses one thread per hardware thread. One always propagates the distance field
+        // and evaluates placement candidates serially.
+        std::size_t m_distanceFieldThreadCount{ 0 };
+
+        // Created the first time work is spread over several threads.
+        std::unique_ptr<WorkerPool> m_workerPool{};
+
+        // Number of room placement attempts evaluated together.
+        std::size_t m_placementCandidateCount{ 1 };
+
+        // build() gives up on spawning more rooms after this many placement attempts in a row fail.
+        std::uint64_t m_maxConsecutiveFailedAttempts{ 1000 };
+
+        // One room placement attempt: the room type it picked and where its ray found space, if anywhere.
+        struct PlacementCandidate
+        {
+            std::optional<std::size_t> roomType{};
+            VectorIntXY cell{};
+            bool isFound{ false };
+            std::uint64_t raySteps{};
+        };
+
+        std::vector<PlacementCandidate> m_placementCandidates{};
+
+        // Cells on the labyrinth's edge that build() connects to the hallways once every room is placed.
+        std::vector<VectorIntXY> m_boundaryDoorCells{};
+
+        // Scratch storage kept across rooms and calls to build(), so a warmed up builder does not allocate.
+        std::vector<VectorIntXY> m_hallwayPath{};
+
+        // Marks of the hallway searches of deferred distance field updates. A cell belongs to the latest search
+        // if its visit is m_hallwaySearchVisit, and is on a shortest path if its visit is one more.
+        struct HallwaySearchCell
+        {
+            std::uint32_t visit{};
+            std::uint32_t depth{};
+        };
+
+        Grid<HallwaySearchCell> m_hallwaySearchCells{};
+        std::uint32_t m_hallwaySearchVisit{};
+        std::vector<VectorIntXY> m_hallwaySearchStarts{};
+        std::vector<VectorIntXY> m_hallwaySearchQueue{};
+        std::vector<VectorIntXY> m_hallwaySearchTargets{};
+
+        Logger m_logger{};
+
         std::vector<VectorIntXY> m_traversalDirections{ {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
 
-        std::default_random_engine m_randomGenerator{};
+        // Every room placement attempt draws from its own stream, derived from the seed and the attempt's index,
+        // so what an attempt draws does not depend on how many numbers earlier attempts used.
+        // This is the index of the next attempt.
+        std::uint64_t m_attemptIndex{};
 
     public:
-        LabyrinthBuilder(
+        BasicLabyrinthBuilder(
             VectorIntXY labyrinthDimensions, 
             int numRoomsToSpawn,
             double cellUnit,
             Room room,
-            std::optional<unsigned int> randomSeed = {});
+            std::optional<std::uint64_t> randomSeed = {});
+
+        /// <summary>
+        /// Build with a room that has already been converted to cell space.
+        /// The labyrinth uses the template's cell unit.
+        /// </summary>
+        BasicLabyrinthBuilder(
+            VectorIntXY labyrinthDimensions,
+            int numRoomsToSpawn,
+            RoomTemplate roomTemplate,
+            std::optional<std::uint64_t> randomSeed = {});
+
+        /// <summary>
+        /// Build with several room types. Each room spawned picks a type by weight,
+        /// respecting every type's minimum and maximum count.
+        /// </summary>
+        BasicLabyrinthBuilder(
+            VectorIntXY labyrinthDimensions,
+            int numRoomsToSpawn,
+            double cellUnit,
+            const std::vector<RoomType>& roomTypes,
+            std::optional<std::uint64_t> randomSeed = {});
+
+        /// <summary>
+        /// Generate a labyrinth. The result stays valid until the next call to build().
+        /// </summary>
+        const LabyrinthResult& build();
+
+        void setDistanceFieldUpdateMode(DistanceFieldUpdateMode mode);
+        void setDistanceFieldEngine(DistanceFieldEngine engine);
+        void setPlacementStrategy(PlacementStrategy strategy);
+
+        /// <summary>
+        /// Seed used by the next build. No seed picks one from the clock.
+        /// </summary>
+        void setRandomSeed(std::optional<std::uint64_t> randomSeed);
+
+        /// <summary>
+        /// Cells that every build connects to its hallways after spawning rooms. Rooms never cover them.
+        /// Used to join neighbouring labyrinths that share an edge.
+        /// A build that cannot reach one of them ends with BuildStatus::BoundaryDoorUnreachable.
+        /// </summary>
+        void setBoundaryDoorCells(const std::vector<VectorIntXY>& cells);
+
+        /// <summary>
+        /// Diagnostic messages above this level are dropped. Defaults to warnings only.
+        /// </summary>
+        void setLogLevel(LogLevel level);
+
+        /// <summary>
+        /// Where diagnostic messages go. An empty sink restores the default, std::cerr.
+        /// </summary>
+        void setLogSink(LogSink sink);
+
+        /// <summary>
+        /// Grids with at least this many cells propagate the distance field in parallel.
+        /// </summary>
+        void setParallelDistanceFieldThreshold(std::size_t cellCount);
+
+        /// <summary>
+        /// Number of threads used for parallel distance field propagation and placement candidate evaluation.
+        /// Zero uses one per hardware thread.
+        /// </summary>
+        void setDistanceFieldThreadCount(std::size_t threadCount);
 
-        void build();
+        /// <summary>
+        /// Evaluate this many room placement attempts at once, in parallel, against the same snapshot of the grid.
+        /// The first attempt, in attempt order, that finds space is committed and later ones are discarded.
+        /// That is the attempt a one at a time search would have committed, so every count builds the same labyrinth.
+        /// Crowded grids, where most attempts fail, benefit the most.
+        /// </summary>
+        void setPlacementCandidateCount(std::size_t count);
+
+        /// <summary>
+        /// Stop spawning rooms once this many placement attempts in a row fail, and report
+        /// BuildStatus::PlacementBudgetExhausted. At least one.
+        /// A labyrinth with no space left at all stops sooner, with BuildStatus::NoSpaceLeft.
+        /// </summary>
+        void setMaxConsecutiveFailedAttempts(std::uint64_t count);
+
+        /// <summary>
+        /// The random stream a build with the given seed uses for room placement attempt number attemptIndex.
+        /// Attempt zero places the first room.
+        /// </summary>
+        static RandomEngine deriveAttemptStream(std::uint64_t randomSeed, std::uint64_t attemptIndex);
+
+        const LabyrinthResult& getResult() const;
+        const DistanceField& getDistanceField() const;
+
+        /// <summary>
+        /// Cells of the last build a room cannot overlap, one bit each: rooms, hallways, potential doors
+        /// and the cells kept clear for boundary doors.
+        /// </summary>
+        const OccupancyBitboard& getOccupancy() const;
+
+        /// <summary>
+        /// Work done placing rooms in the last build.
+        /// </summary>
+        const PlacementCounters& getPlacementCounters() const;
+
+        /// <summary>
+        /// Number of rooms of each type spawned by the last build, in the order the types were given.
+        /// </summary>
+        const std::vector<int>& getRoomTypeCounts() const;
 
     private:
+        BasicLabyrinthBuilder(
+            VectorIntXY labyrinthDimensions,
+            int numRoomsToSpawn,
+            double cellUnit,
+            std::vector<CompiledRoomType> roomTypes,
+            std::optional<std::uint64_t> randomSeed);
+
+        static std::vector<CompiledRoomType> compileRoomTypes(const std::vector<RoomType>& roomTypes, double cellUnit);
+
         void spawnRooms     ();
-        void spawnFirstRoom ();
-        void spawnRoom      (VectorIntXY cell);
+        bool spawnFirstRoom (std::size_t roomType);
+        void spawnRoom      (VectorIntXY cell, std::size_t roomType);
 
-        void addRoomToDistanceField      (VectorIntXY cell);
-        void addRoomDoorsToDistanceField (VectorIntXY cell);
+        void addRoomToDistanceField      (VectorIntXY cell, const RoomTemplate& roomTemplate);
+        void addRoomDoorsToDistanceField (VectorIntXY cell, const RoomTemplate& roomTemplate);
 
-        VectorIntXY findDoorCoordinate            (VectorIntXY roomCell, PlaneTransform door);
-        bool        isInDistanceField             (VectorIntXY cell);
-        bool        areRoomExtentsWithinLabyrinth (VectorIntXY position, int sizeX, int sizeY);
+        void evaluatePlacementCandidates(std::size_t count);
+        void evaluatePlacementCandidate(std::uint64_t attemptIndex, PlacementCandidate& candidate) const;
+
+        bool canAnyEligibleRoomTypeFit() const;
+
+        void resetPlacementIndexes();
+
+        void updateRoomTypeSelection(int roomsRemaining);
+        std::optional<std::size_t> pickRoomType(RandomEngine& randomEngine) const;
+        void rebuildRoomTypeSelection();
+        bool canRoomTypeFit(std::size_t roomType) const;
+        void countRoomType(std::size_t roomType);
+
+        bool        isInDistanceField             (VectorIntXY cell) const;
+        bool        areRoomExtentsWithinLabyrinth (VectorIntXY position, int sizeX, int sizeY) const;
+
+        void blockCell(VectorIntXY cell);
+        void blockCells(VectorIntXY min, VectorIntXY size);
 
         void setPotentialDoorCell(VectorIntXY labyrinthCoordinate);
         void setHallwayCell(VectorIntXY cell);
 
-        VectorXY nextCoordinateAlongSearchPath(VectorXY currentposition, VectorXY searchDirection);
+        void connectToExistingRooms(VectorIntXY roomSpawnCoordinate, const RoomTemplate& roomTemplate);
+        void connectBoundaryDoors();
+        bool carveHallway(VectorIntXY start);
+        bool carveHallwayBySearch(const std::vector<VectorIntXY>& starts);
+        bool findHallwayPath(const std::vector<VectorIntXY>& starts);
+        void carveHallwayPath();
 
-        void connectToExistingRooms(VectorIntXY roomSpawnCoordinate, const Room& room);
+        std::int64_t getPathOrder(VectorIntXY cell) const;
 
         void recalculateDistanceField();
-
-        void debugCoutDistanceField();
+        bool shouldPropagateDistanceFieldInParallel();
+        WorkerPool& getWorkerPool();
     };
 
+    extern template class BasicLabyrinthBuilder<Xoshiro256StarStar>;
+    extern template class BasicLabyrinthBuilder<std::mt19937_64>;
+
+    /// <summary>
+    /// The builder with the default random engine.
+    /// </summary>
+    using LabyrinthBuilder = BasicLabyrinthBuilder<>;
+
     void runLabyrinthBuilderTests();
 }
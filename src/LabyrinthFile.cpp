@@ -0,0 +1,574 @@
+#include "LabyrinthFile.h"
+
+#include "LabyrinthBuilder.h"
+#include "SelfTest.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        constexpr char MAGIC[4]{ 'L', 'A', 'B', 'Y' };
+        constexpr std::size_t HEADER_SIZE{ 44 };
+        constexpr std::size_t ROOM_SIZE{ 20 };
+        constexpr std::size_t HALLWAY_CELL_SIZE{ 8 };
+
+        std::size_t paddedToFour(std::size_t size)
+        {
+            return (size + 3) & ~std::size_t{ 3 };
+        }
+
+        void appendUint32(std::string& bytes, std::uint32_t value)
+        {
+            for (int shift = 0; shift < 32; shift += 8)
+            {
+                bytes.push_back(static_cast<char>((value >> shift) & 0xFF));
+            }
+        }
+
+        void appendInt32(std::string& bytes, std::int32_t value)
+        {
+            appendUint32(bytes, static_cast<std::uint32_t>(value));
+        }
+
+        void appendUint64(std::string& bytes, std::uint64_t value)
+        {
+            appendUint32(bytes, static_cast<std::uint32_t>(value));
+            appendUint32(bytes, static_cast<std::uint32_t>(value >> 32));
+        }
+
+        // Assembled from single bytes, so reads are independent of alignment and host byte order.
+        std::uint32_t readUint32(const std::byte* bytes)
+        {
+            return
+                std::uint32_t{ std::to_integer<std::uint8_t>(bytes[0]) } |
+                (std::uint32_t{ std::to_integer<std::uint8_t>(bytes[1]) } << 8) |
+                (std::uint32_t{ std::to_integer<std::uint8_t>(bytes[2]) } << 16) |
+                (std::uint32_t{ std::to_integer<std::uint8_t>(bytes[3]) } << 24);
+        }
+
+        std::int32_t readInt32(const std::byte* bytes)
+        {
+            return static_cast<std::int32_t>(readUint32(bytes));
+        }
+
+        std::uint64_t readUint64(const std::byte* bytes)
+        {
+            return std::uint64_t{ readUint32(bytes) } | (std::uint64_t{ readUint32(bytes + 4) } << 32);
+        }
+
+        void throwInvalid(const std::string& reason)
+        {
+            throw std::runtime_error{ "Invalid labyrinth file: " + reason };
+        }
+    }
+
+    void writeLabyrinth(const LabyrinthResult& result, std::ostream& out)
+    {
+        const DistanceField& distanceField{ result.distanceField };
+        const VectorIntXY& dimensions{ distanceField.getDimensions() };
+
+        // Run length encode the cell kinds one row at a time.
+        std::vector<std::uint32_t> rowTable{};
+        std::vector<std::uint32_t> runStarts{};
+        std::string runKinds{};
+        rowTable.reserve(static_cast<std::size_t>(dimensions.y) + 1);
+
+        for (int y = 0; y < dimensions.y; y++)
+        {
+            rowTable.push_back(static_cast<std::uint32_t>(runStarts.size()));
+
+            for (int x = 0; x < dimensions.x; x++)
+            {
+                CellKind kind{ distanceField.getKind(VectorIntXY{ x, y }) };
+                if (x == 0 || kind != distanceField.getKind(VectorIntXY{ x - 1, y }))
+                {
+                    runStarts.push_back(static_cast<std::uint32_t>(x));
+                    runKinds.push_back(static_cast<char>(kind));
+                }
+            }
+        }
+        rowTable.push_back(static_cast<std::uint32_t>(runStarts.size()));
+        runKinds.resize(paddedToFour(runKinds.size()), '\0');
+
+        std::string bytes{};
+        bytes.reserve(
+            HEADER_SIZE +
+            (rowTable.size() * 4) +
+            (runStarts.size() * 4) +
+            runKinds.size() +
+            (result.rooms.size() * ROOM_SIZE) +
+            (result.hallwayCells.size() * HALLWAY_CELL_SIZE));
+
+        bytes.append(MAGIC, sizeof(MAGIC));
+        appendUint32(bytes, LABYRINTH_FILE_VERSION);
+        appendInt32(bytes, dimensions.x);
+        appendInt32(bytes, dimensions.y);
+        appendUint64(bytes, std::bit_cast<std::uint64_t>(result.cellUnit));
+        appendUint64(bytes, result.randomSeed);
+        appendUint32(bytes, static_cast<std::uint32_t>(runStarts.size()));
+        appendUint32(bytes, static_cast<std::uint32_t>(result.rooms.size()));
+        appendUint32(bytes, static_cast<std::uint32_t>(result.hallwayCells.size()));
+
+        for (std::uint32_t firstRun : rowTable)
+        {
+            appendUint32(bytes, firstRun);
+        }
+
+        for (std::uint32_t runStart : runStarts)
+        {
+            appendUint32(bytes, runStart);
+        }
+
+        bytes += runKinds;
+
+        for (const RoomPlacement& room : result.rooms)
+        {
+            appendInt32(bytes, room.min.x);
+            appendInt32(bytes, room.min.y);
+            appendInt32(bytes, room.size.x);
+            appendInt32(bytes, room.size.y);
+            appendUint32(bytes, static_cast<std::uint32_t>(room.roomType));
+        }
+
+        for (VectorIntXY cell : result.hallwayCells)
+        {
+            appendInt32(bytes, cell.x);
+            appendInt32(bytes, cell.y);
+        }
+
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    void saveLabyrinth(const LabyrinthResult& result, const std::string& path)
+    {
+        std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+        writeLabyrinth(result, out);
+
+        if (!out)
+        {
+            throw std::runtime_error{ "Could not write labyrinth file " + path };
+        }
+    }
+
+    LabyrinthView::LabyrinthView(const std::byte* data, std::size_t size)
+    {
+        if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throwInvalid("missing header");
+        }
+
+        std::uint32_t version{ readUint32(data + 4) };
+        if (version != LABYRINTH_FILE_VERSION)
+        {
+            throwInvalid("unsupported version " + std::to_string(version));
+        }
+
+        m_dimensions = VectorIntXY{ readInt32(data + 8), readInt32(data + 12) };
+        m_cellUnit = std::bit_cast<double>(readUint64(data + 16));
+        m_randomSeed = readUint64(data + 24);
+        m_runCount = readUint32(data + 32);
+        m_roomCount = readUint32(data + 36);
+        m_hallwayCellCount = readUint32(data + 40);
+
+        if (m_dimensions.x < 1 || m_dimensions.y < 1)
+        {
+            throwInvalid("dimensions must be natural numbers");
+        }
+
+        // Every count is at most 32 bits, so none of these sizes can overflow.
+        std::uint64_t rowTableSize{ (std::uint64_t{ static_cast<std::uint32_t>(m_dimensions.y) } + 1) * 4 };
+        std::uint64_t runStartsSize{ std::uint64_t{ m_runCount } * 4 };
+        std::uint64_t runKindsSize{ paddedToFour(m_runCount) };
+        std::uint64_t roomsSize{ std::uint64_t{ m_roomCount } * ROOM_SIZE };
+        std::uint64_t hallwayCellsSize{ std::uint64_t{ m_hallwayCellCount } * HALLWAY_CELL_SIZE };
+
+        if (HEADER_SIZE + rowTableSize + runStartsSize + runKindsSize + roomsSize + hallwayCellsSize != size)
+        {
+            throwInvalid("size does not match its header");
+        }
+
+        m_rowTable = data + HEADER_SIZE;
+        m_runStarts = m_rowTable + rowTableSize;
+        m_runKinds = m_runStarts + runStartsSize;
+        m_rooms = m_runKinds + runKindsSize;
+        m_hallwayCells = m_rooms + roomsSize;
+
+        // Rows are checked when they are read, so opening a file takes the same time whatever its size.
+        if (getRowFirstRun(0) != 0 || getRowFirstRun(m_dimensions.y) != m_runCount)
+        {
+            throwInvalid("row table does not cover the runs");
+        }
+    }
+
+    const VectorIntXY& LabyrinthView::getDimensions() const
+    {
+        return m_dimensions;
+    }
+
+    double LabyrinthView::getCellUnit() const
+    {
+        return m_cellUnit;
+    }
+
+    std::uint64_t LabyrinthView::getRandomSeed() const
+    {
+        return m_randomSeed;
+    }
+
+    std::size_t LabyrinthView::getRunCount() const
+    {
+        return m_runCount;
+    }
+
+    CellKind LabyrinthView::getKind(VectorIntXY cell) const
+    {
+        if (cell.x < 0 || cell.x >= m_dimensions.x)
+        {
+            throw std::runtime_error{ "LabyrinthView cell " + cell.toString() + " is outside the labyrinth!" };
+        }
+
+        // Find the last run of the row that starts at or before the cell.
+        std::uint32_t low{};
+        std::uint32_t high{};
+        getRowRuns(cell.y, low, high);
+
+        while (high - low > 1)
+        {
+            std::uint32_t middle{ low + ((high - low) / 2) };
+            if (getRunStart(middle) <= static_cast<std::uint32_t>(cell.x))
+            {
+                low = middle;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        if (std::to_integer<std::uint8_t>(m_runKinds[low]) > static_cast<std::uint8_t>(CellKind::Hall))
+        {
+            throwInvalid("row " + std::to_string(cell.y) + " has a malformed run");
+        }
+
+        return getRunKind(low);
+    }
+
+    void LabyrinthView::decodeRow(int y, CellKind* out) const
+    {
+        std::uint32_t firstRun{};
+        std::uint32_t endRun{};
+        getRowRuns(y, firstRun, endRun);
+        checkRowRuns(y, firstRun, endRun);
+
+        for (std::uint32_t run = firstRun; run < endRun; run++)
+        {
+            std::uint32_t runEnd{ run + 1 < endRun ? getRunStart(run + 1) : static_cast<std::uint32_t>(m_dimensions.x) };
+            std::fill(out + getRunStart(run), out + runEnd, getRunKind(run));
+        }
+    }
+
+    std::size_t LabyrinthView::getRoomCount() const
+    {
+        return m_roomCount;
+    }
+
+    RoomPlacement LabyrinthView::getRoom(std::size_t index) const
+    {
+        if (index >= m_roomCount)
+        {
+            throw std::runtime_error{ "LabyrinthView room " + std::to_string(index) + " is past the room count!" };
+        }
+
+        const std::byte* room{ m_rooms + (index * ROOM_SIZE) };
+
+        return RoomPlacement{
+            VectorIntXY{ readInt32(room), readInt32(room + 4) },
+            VectorIntXY{ readInt32(room + 8), readInt32(room + 12) },
+            readUint32(room + 16) };
+    }
+
+    std::size_t LabyrinthView::getHallwayCellCount() const
+    {
+        return m_hallwayCellCount;
+    }
+
+    VectorIntXY LabyrinthView::getHallwayCell(std::size_t index) const
+    {
+        if (index >= m_hallwayCellCount)
+        {
+            throw std::runtime_error{ "LabyrinthView hallway cell " + std::to_string(index) + " is past the hallway cell count!" };
+        }
+
+        const std::byte* cell{ m_hallwayCells + (index * HALLWAY_CELL_SIZE) };
+        return VectorIntXY{ readInt32(cell), readInt32(cell + 4) };
+    }
+
+    LabyrinthResult LabyrinthView::toResult() const
+    {
+        LabyrinthResult result{};
+        result.distanceField = DistanceField{ m_dimensions };
+        result.randomSeed = m_randomSeed;
+        result.cellUnit = m_cellUnit;
+
+        for (int y = 0; y < m_dimensions.y; y++)
+        {
+            std::uint32_t firstRun{};
+            std::uint32_t endRun{};
+            getRowRuns(y, firstRun, endRun);
+            checkRowRuns(y, firstRun, endRun);
+
+            for (std::uint32_t run = firstRun; run < endRun; run++)
+            {
+                CellKind kind{ getRunKind(run) };
+                if (kind == CellKind::Open)
+                {
+                    continue;
+                }
+
+                int start{ static_cast<int>(getRunStart(run)) };
+                int end{ run + 1 < endRun ? static_cast<int>(getRunStart(run + 1)) : m_dimensions.x };
+                result.distanceField.setKind(VectorIntXY{ start, y }, VectorIntXY{ end - start, 1 }, kind);
+            }
+        }
+
+        result.distanceField.recalculate();
+
+        result.rooms.reserve(m_roomCount);
+        for (std::size_t i = 0; i < m_roomCount; i++)
+        {
+            result.rooms.push_back(getRoom(i));
+        }
+
+        result.hallwayCells.reserve(m_hallwayCellCount);
+        for (std::size_t i = 0; i < m_hallwayCellCount; i++)
+        {
+            result.hallwayCells.push_back(getHallwayCell(i));
+        }
+
+        return result;
+    }
+
+    void LabyrinthView::getRowRuns(int y, std::uint32_t& firstRun, std::uint32_t& endRun) const
+    {
+        if (y < 0 || y >= m_dimensions.y)
+        {
+            throw std::runtime_error{ "LabyrinthView row " + std::to_string(y) + " is outside the labyrinth!" };
+        }
+
+        firstRun = getRowFirstRun(y);
+        endRun = getRowFirstRun(y + 1);
+
+        if (endRun <= firstRun || endRun > m_runCount)
+        {
+            throwInvalid("row " + std::to_string(y) + " has no runs");
+        }
+    }
+
+    void LabyrinthView::checkRowRuns(int y, std::uint32_t firstRun, std::uint32_t endRun) const
+    {
+        if (getRunStart(firstRun) != 0)
+        {
+            throwInvalid("row " + std::to_string(y) + " has no run at column zero");
+        }
+
+        for (std::uint32_t run = firstRun; run < endRun; run++)
+        {
+            if ((run > firstRun && getRunStart(run) <= getRunStart(run - 1)) ||
+                getRunStart(run) >= static_cast<std::uint32_t>(m_dimensions.x) ||
+                std::to_integer<std::uint8_t>(m_runKinds[run]) > static_cast<std::uint8_t>(CellKind::Hall))
+            {
+                throwInvalid("row " + std::to_string(y) + " has a malformed run");
+            }
+        }
+    }
+
+    std::uint32_t LabyrinthView::getRowFirstRun(int y) const
+    {
+        // The table has an entry past the last row, which ends it.
+        if (y < 0 || y > m_dimensions.y)
+        {
+            throw std::runtime_error{ "LabyrinthView row " + std::to_string(y) + " is outside the row table!" };
+        }
+
+        return readUint32(m_rowTable + (static_cast<std::size_t>(y) * 4));
+    }
+
+    std::uint32_t LabyrinthView::getRunStart(std::uint32_t run) const
+    {
+        return readUint32(m_runStarts + (static_cast<std::size_t>(run) * 4));
+    }
+
+    CellKind LabyrinthView::getRunKind(std::uint32_t run) const
+    {
+        return static_cast<CellKind>(m_runKinds[run]);
+    }
+
+    MappedLabyrinth::MappedLabyrinth(const std::string& path) :
+        m_file{ path },
+        m_view{ m_file.data(), m_file.size() }
+    {
+    }
+
+    const LabyrinthView& MappedLabyrinth::getView() const
+    {
+        return m_view;
+    }
+
+    void runLabyrinthFileTests()
+    {
+        Room room
+        {
+            Vector3{6, 6, 3},
+            {
+                PlaneTransform{ Vector3{3, 0, 0}, VectorXY{0, -1} },
+                PlaneTransform{ Vector3{3, 6, 0}, VectorXY{0, 1} },
+                PlaneTransform{ Vector3{0, 3, 0}, VectorXY{-1, 0} },
+                PlaneTransform{ Vector3{6, 3, 0}, VectorXY{1, 0} },
+            }
+        };
+
+        LabyrinthBuilder builder{ VectorIntXY{60, 50}, 12, 2.0, room, 5u };
+        const LabyrinthResult& result{ builder.build() };
+
+        std::ostringstream out{};
+        writeLabyrinth(result, out);
+        std::string bytes{ out.str() };
+
+        // Round trip through memory.
+        LabyrinthView view{ reinterpret_cast<const std::byte*>(bytes.data()), bytes.size() };
+        LABYRINTH_CHECK(VectorIntXY(60, 50) == view.getDimensions());
+        LABYRINTH_CHECK(2.0 == view.getCellUnit());
+        LABYRINTH_CHECK(5u == view.getRandomSeed());
+
+        // Seeds keep all 64 bits.
+        {
+            LabyrinthResult wideSeedResult{ result };
+            wideSeedResult.randomSeed = 0x123456789ABCDEF0ull;
+            std::ostringstream wideSeedOut{};
+            writeLabyrinth(wideSeedResult, wideSeedOut);
+            std::string wideSeedBytes{ wideSeedOut.str() };
+
+            LabyrinthView wideSeedView{ reinterpret_cast<const std::byte*>(wideSeedBytes.data()), wideSeedBytes.size() };
+            LABYRINTH_CHECK(0x123456789ABCDEF0ull == wideSeedView.getRandomSeed());
+        }
+
+        // Run length encoding stores far fewer runs than cells.
+        LABYRINTH_CHECK(view.getRunCount() < 60 * 50 / 4);
+
+        std::vector<CellKind> row(60);
+        for (int y = 0; y < 50; y++)
+        {
+            view.decodeRow(y, row.data());
+
+            for (int x = 0; x < 60; x++)
+            {
+                LABYRINTH_CHECK(result.distanceField.getKind(VectorIntXY{ x, y }) == view.getKind(VectorIntXY{ x, y }));
+                LABYRINTH_CHECK(result.distanceField.getKind(VectorIntXY{ x, y }) == row[x]);
+            }
+        }
+
+        LABYRINTH_CHECK(result.rooms.size() == view.getRoomCount());
+        for (std::size_t i = 0; i < result.rooms.size(); i++)
+        {
+            LABYRINTH_CHECK(result.rooms[i] == view.getRoom(i));
+        }
+
+        LABYRINTH_CHECK(result.hallwayCells.size() == view.getHallwayCellCount());
+        for (std::size_t i = 0; i < result.hallwayCells.size(); i++)
+        {
+            LABYRINTH_CHECK(result.hallwayCells[i] == view.getHallwayCell(i));
+        }
+
+        // Decoding gives back the built result with its distances recalculated from the stored kinds.
+        LabyrinthResult decoded{ view.toResult() };
+        LabyrinthResult recalculated{ result };
+        recalculated.distanceField.recalculate();
+        LABYRINTH_CHECK(recalculated == decoded);
+
+        // Round trip through a memory mapped file.
+        std::filesystem::path path{ std::filesystem::temp_directory_path() / "LabyrinthGenerationFileTest.laby" };
+        saveLabyrinth(result, path.string());
+        {
+            MappedLabyrinth mapped{ path.string() };
+            LABYRINTH_CHECK(view.getRunCount() == mapped.getView().getRunCount());
+            LABYRINTH_CHECK(decoded == mapped.getView().toResult());
+        }
+        std::filesystem::remove(path);
+
+        // Damaged files are rejected when opened, or damaged rows when they are read.
+        auto isRejected = [](std::string damaged)
+        {
+            try
+            {
+                LabyrinthView damagedView{ reinterpret_cast<const std::byte*>(damaged.data()), damaged.size() };
+            }
+            catch (const std::runtime_error&)
+            {
+                return true;
+            }
+            return false;
+        };
+
+        LABYRINTH_CHECK(isRejected(bytes.substr(0, bytes.size() - 1)));
+        LABYRINTH_CHECK(isRejected(bytes.substr(0, 10)));
+
+        std::string wrongVersion{ bytes };
+        wrongVersion[4] = 2;
+        LABYRINTH_CHECK(isRejected(wrongVersion));
+
+        std::string wrongRowTable{ bytes };
+        wrongRowTable[HEADER_SIZE + 4] = static_cast<char>(0xFF);
+        LABYRINTH_CHECK(!isRejected(wrongRowTable));
+
+        LabyrinthView damagedView{ reinterpret_cast<const std::byte*>(wrongRowTable.data()), wrongRowTable.size() };
+        auto isRowRejected = [&](int y)
+        {
+            try
+            {
+                damagedView.decodeRow(y, row.data());
+            }
+            catch (const std::runtime_error&)
+            {
+                return true;
+            }
+            return false;
+        };
+
+        LABYRINTH_CHECK(isRowRejected(0));
+        LABYRINTH_CHECK(isRowRejected(1));
+        LABYRINTH_CHECK(!isRowRejected(2));
+
+        // Asking for anything past the header's dimensions or counts throws instead of reading outside the buffer.
+        auto isReadRejected = [](auto read)
+        {
+            try
+            {
+                read();
+            }
+            catch (const std::runtime_error&)
+            {
+                return true;
+            }
+            return false;
+        };
+
+        LABYRINTH_CHECK(isReadRejected([&]() { view.decodeRow(-1, row.data()); }));
+        LABYRINTH_CHECK(isReadRejected([&]() { view.decodeRow(50, row.data()); }));
+        LABYRINTH_CHECK(isReadRejected([&]() { view.getKind(VectorIntXY{ 0, 50 }); }));
+        LABYRINTH_CHECK(isReadRejected([&]() { view.getKind(VectorIntXY{ 0, -1 }); }));
+        LABYRINTH_CHECK(isReadRejected([&]() { view.getKind(VectorIntXY{ 60, 0 }); }));
+        LABYRINTH_CHECK(isReadRejected([&]() { view.getKind(VectorIntXY{ -1, 0 }); }));
+        LABYRINTH_CHECK(isReadRejected([&]() { view.getRoom(view.getRoomCount()); }));
+        LABYRINTH_CHECK(isReadRejected([&]() { view.getHallwayCell(view.getHallwayCellCount()); }));
+        LABYRINTH_CHECK(!isReadRejected([&]() { view.getKind(VectorIntXY{ 59, 49 }); }));
+    }
+}
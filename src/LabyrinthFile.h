@@ -0,0 +1,130 @@
+#pragma once
+
+#include "DistanceField.h"
+#include "LabyrinthResult.h"
+#include "MappedFile.h"
+#include "VectorIntXY.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Binary file format for generated labyrinths. All values are little endian.
+    ///
+    ///   header        "LABY", uint32 version, int32 width, int32 height, float64 cell unit,
+    ///                 uint64 seed, uint32 run count, uint32 room count, uint32 hallway cell count
+    ///   row table     uint32 index of each row's first run, plus one past the last run
+    ///   run starts    uint32 first column of each run. Each row's runs start at column zero and increase
+    ///   run kinds     uint8 CellKind of each run, padded to four bytes
+    ///   rooms         int32 min x, min y, size x, size y, uint32 room type
+    ///   hallway cells int32 x, y
+    ///
+    /// Only cell kinds are stored. Distances are recalculated from them when needed.
+    /// </summary>
+    constexpr std::uint32_t LABYRINTH_FILE_VERSION{ 1 };
+
+    void writeLabyrinth(const LabyrinthResult& result, std::ostream& out);
+
+    /// <summary>
+    /// Throws std::runtime_error if the file cannot be written.
+    /// </summary>
+    void saveLabyrinth(const LabyrinthResult& result, const std::string& path);
+
+    /// <summary>
+    /// Reads a labyrinth file in place, without copying or decoding it up front.
+    ///
+    /// Creating a view only checks the header, the file size and the ends of the row table, so it takes constant time.
+    /// A row's table entries and runs are checked when the row is read, and reading a malformed row throws
+    /// std::runtime_error instead of reading outside the buffer. So does asking for a cell, row, room or hallway cell
+    /// past the counts in the header. The buffer must outlive the view.
+    /// </summary>
+    class LabyrinthView
+    {
+        const std::byte* m_rowTable{ nullptr };
+        const std::byte* m_runStarts{ nullptr };
+        const std::byte* m_runKinds{ nullptr };
+        const std::byte* m_rooms{ nullptr };
+        const std::byte* m_hallwayCells{ nullptr };
+
+        VectorIntXY m_dimensions{};
+        double m_cellUnit{ 1 };
+        std::uint64_t m_randomSeed{};
+        std::uint32_t m_runCount{};
+        std::uint32_t m_roomCount{};
+        std::uint32_t m_hallwayCellCount{};
+
+    public:
+        LabyrinthView() = default;
+
+        /// <summary>
+        /// Throws std::runtime_error if the bytes are not a valid labyrinth file of the current version.
+        /// </summary>
+        LabyrinthView(const std::byte* data, std::size_t size);
+
+        const VectorIntXY& getDimensions() const;
+        double getCellUnit() const;
+        std::uint64_t getRandomSeed() const;
+
+        /// <summary>
+        /// Number of runs in the run length encoded cell kind plane.
+        /// </summary>
+        std::size_t getRunCount() const;
+
+        /// <summary>
+        /// Binary searches the row's runs. Only the row table entries and the kind of the run found are checked.
+        /// </summary>
+        CellKind getKind(VectorIntXY cell) const;
+
+        /// <summary>
+        /// Write the kinds of every cell of a row to out, which must hold the labyrinth's width.
+        /// </summary>
+        void decodeRow(int y, CellKind* out) const;
+
+        std::size_t getRoomCount() const;
+        RoomPlacement getRoom(std::size_t index) const;
+
+        std::size_t getHallwayCellCount() const;
+        VectorIntXY getHallwayCell(std::size_t index) const;
+
+        /// <summary>
+        /// Decode everything. The distance field is recalculated from the stored cell kinds,
+        /// so it holds the exact shortest distances, as DistanceField::recalculate() gives them.
+        /// A builder that lowered its distances a room at a time can hold smaller stale ones.
+        /// </summary>
+        LabyrinthResult toResult() const;
+
+    private:
+        // Throws unless the row's table entries give a nonempty range of runs inside the run plane.
+        void getRowRuns(int y, std::uint32_t& firstRun, std::uint32_t& endRun) const;
+
+        // Throws unless the runs start at column zero, increase inside the row and hold valid kinds.
+        void checkRowRuns(int y, std::uint32_t firstRun, std::uint32_t endRun) const;
+
+        std::uint32_t getRowFirstRun(int y) const;
+        std::uint32_t getRunStart(std::uint32_t run) const;
+        CellKind getRunKind(std::uint32_t run) const;
+    };
+
+    /// <summary>
+    /// A labyrinth file mapped into memory and read through a LabyrinthView.
+    /// </summary>
+    class MappedLabyrinth
+    {
+        MappedFile m_file;
+        LabyrinthView m_view;
+
+    public:
+        /// <summary>
+        /// Throws std::runtime_error if the file cannot be mapped or is not a valid labyrinth file.
+        /// </summary>
+        explicit MappedLabyrinth(const std::string& path);
+
+        const LabyrinthView& getView() const;
+    };
+
+    void runLabyrinthFileTests();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "DistanceField.h"
+#include "LabyrinthStats.h"
+#include "VectorIntXY.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Where a room was spawned: its minimum corner and size in cells, and which room type it is.
+    /// </summary>
+    struct RoomPlacement
+    {
+        VectorIntXY min;
+        VectorIntXY size;
+        std::size_t roomType;
+
+        friend bool operator==(const RoomPlacement& left, const RoomPlacement& right) = default;
+    };
+
+    /// <summary>
+    /// Whether a build spawned every room it was asked for, and if not, why it stopped.
+    /// </summary>
+    enum class BuildStatus
+    {
+        Complete,
+
+        // Every room type reached its maximum count.
+        RoomTypesExhausted,
+
+        // No footprint of any room type that could still spawn fits anywhere in the labyrinth.
+        NoSpaceLeft,
+
+        // Too many placement attempts in a row failed. Space may be left that no search path reached.
+        PlacementBudgetExhausted,
+
+        // A boundary door could not be joined to any hallway, so the labyrinth does not connect to its neighbour there.
+        // Takes precedence over how room placement went.
+        BoundaryDoorUnreachable
+    };
+
+    /// <summary>
+    /// Everything a build produces.
+    /// </summary>
+    struct LabyrinthResult
+    {
+        DistanceField distanceField;
+
+        // In the order the rooms were spawned.
+        std::vector<RoomPlacement> rooms{};
+
+        // In the order the hallways were carved.
+        std::vector<VectorIntXY> hallwayCells{};
+
+        // The seed the build used, including one picked from the clock.
+        std::uint64_t randomSeed{};
+
+        // World space size of one side of a cell.
+        double cellUnit{ 1 };
+
+        // How the build went. Not part of the labyrinth, so equality ignores them.
+        BuildStatus status{ BuildStatus::Complete };
+        LabyrinthStats stats{};
+
+        friend bool operator==(const LabyrinthResult& left, const LabyrinthResult& right)
+        {
+            return left.distanceField == right.distanceField &&
+                left.rooms == right.rooms &&
+                left.hallwayCells == right.hallwayCells &&
+                left.randomSeed == right.randomSeed &&
+                left.cellUnit == right.cellUnit;
+        }
+    };
+}
@@ -0,0 +1,90 @@
+#include "LabyrinthStats.h"
+
+#include "LabyrinthResult.h"
+#include "SelfTest.h"
+
+#include <sstream>
+#include <string>
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        const char* getBuildStatusName(BuildStatus status)
+        {
+            switch (status)
+            {
+            case BuildStatus::Complete:
+                return "Complete";
+            case BuildStatus::RoomTypesExhausted:
+                return "RoomTypesExhausted";
+            case BuildStatus::NoSpaceLeft:
+                return "NoSpaceLeft";
+            case BuildStatus::PlacementBudgetExhausted:
+                return "PlacementBudgetExhausted";
+            case BuildStatus::BoundaryDoorUnreachable:
+                return "BoundaryDoorUnreachable";
+            default:
+                return "Unknown";
+            }
+        }
+    }
+
+    void writeStatsJsonLine(const LabyrinthResult& result, std::ostream& out)
+    {
+        const LabyrinthStats& stats{ result.stats };
+        const VectorIntXY& dimensions{ result.distanceField.getDimensions() };
+
+        // Every value but the status is an integer, and status names are plain identifiers,
+        // so nothing needs escaping or locale independent number formatting.
+        out << "{\"seed\":" << result.randomSeed
+            << ",\"width\":" << dimensions.x
+            << ",\"height\":" << dimensions.y
+            << ",\"status\":\"" << getBuildStatusName(result.status) << '"'
+            << ",\"rooms\":" << result.rooms.size()
+            << ",\"roomsPlaced\":" << stats.placement.roomsPlaced
+            << ",\"totalNs\":" << stats.totalTime.count()
+            << ",\"firstRoomNs\":" << stats.firstRoomTime.count()
+            << ",\"spawnSearchNs\":" << stats.spawnSearchTime.count()
+            << ",\"hallwayCarveNs\":" << stats.hallwayCarveTime.count()
+            << ",\"distanceFieldNs\":" << stats.distanceFieldTime.count()
+            << ",\"distanceFieldCellsVisited\":" << stats.distanceFieldCellsVisited
+            << ",\"hallwayLength\":" << stats.hallwayLength
+            << ",\"peakGridBytes\":" << stats.peakGridBytes
+            << ",\"attemptsEvaluated\":" << stats.placement.attemptsEvaluated
+            << ",\"failedAttempts\":" << stats.placement.failedAttempts
+            << ",\"discardedAttempts\":" << stats.placement.discardedAttempts
+            << ",\"raySteps\":" << stats.placement.raySteps
+            << ",\"spaceScans\":" << stats.placement.spaceScans
+            << "}\n";
+    }
+
+    void runLabyrinthStatsTests()
+    {
+        LabyrinthResult result{ DistanceField{ VectorIntXY{ 12, 10 } } };
+        result.randomSeed = 42;
+        result.stats.totalTime = std::chrono::nanoseconds{ 1500 };
+        result.stats.hallwayLength = 17;
+        result.stats.placement.failedAttempts = 3;
+        result.stats.placement.roomsPlaced = 5;
+        result.status = BuildStatus::NoSpaceLeft;
+
+        std::ostringstream out{};
+        writeStatsJsonLine(result, out);
+        writeStatsJsonLine(result, out);
+
+        std::string lines{ out.str() };
+        std::string line{ lines.substr(0, lines.find('\n') + 1) };
+
+        LABYRINTH_CHECK(lines == line + line);
+        LABYRINTH_CHECK(line.starts_with("{\"seed\":42,\"width\":12,\"height\":10,\"status\":\"NoSpaceLeft\",\"rooms\":0,\"roomsPlaced\":5,\"totalNs\":1500,"));
+        LABYRINTH_CHECK(line.find(",\"hallwayLength\":17,") != std::string::npos);
+        LABYRINTH_CHECK(line.find(",\"failedAttempts\":3,") != std::string::npos);
+        LABYRINTH_CHECK(line.ends_with("}\n"));
+
+        // Statistics describe how a labyrinth was built, not the labyrinth, so they do not affect equality.
+        LabyrinthResult sameLabyrinth{ result };
+        sameLabyrinth.stats = LabyrinthStats{};
+        LABYRINTH_CHECK(result == sameLabyrinth);
+    }
+}
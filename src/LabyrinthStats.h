@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Define as 0 to compile out build() instrumentation. Statistics then stay at zero,
+// except for the placement counters, which room placement keeps either way.
+#ifndef LABYRINTH_ENABLE_STATS
+#define LABYRINTH_ENABLE_STATS 1
+#endif
+
+namespace LabyrinthGeneration
+{
+    constexpr bool ARE_STATS_ENABLED{ LABYRINTH_ENABLE_STATS != 0 };
+
+    /// <summary>
+    /// Room placement work done by a build.
+    /// </summary>
+    struct PlacementCounters
+    {
+        // Including the first room, which is placed without a search.
+        std::uint64_t roomsPlaced{};
+
+        // Search rays cast, including discarded ones.
+        std::uint64_t attemptsEvaluated{};
+
+        // Rays that reached the edge of the labyrinth without finding space.
+        std::uint64_t failedAttempts{};
+
+        // Rays evaluated in a batch after the one that was committed or that ended the search.
+        std::uint64_t discardedAttempts{};
+
+        // Footprint overlap tests along every ray.
+        std::uint64_t raySteps{};
+
+        // Scans of every position for space left, after several failed attempts in a row.
+        std::uint64_t spaceScans{};
+    };
+
+    /// <summary>
+    /// Where a build spent its time and how much work it did.
+    /// Phase times do not overlap, and the rest of totalTime is bookkeeping between phases.
+    /// </summary>
+    struct LabyrinthStats
+    {
+        std::chrono::nanoseconds totalTime{};
+        std::chrono::nanoseconds firstRoomTime{};
+        std::chrono::nanoseconds spawnSearchTime{};
+        std::chrono::nanoseconds hallwayCarveTime{};
+        std::chrono::nanoseconds distanceFieldTime{};
+
+        // Cells taken off the distance field's search queue, summed over every recalculation.
+        std::uint64_t distanceFieldCellsVisited{};
+
+        // Hallway cells carved, including boundary door connections.
+        std::uint64_t hallwayLength{};
+
+        // Largest cell storage of the distance field and blocked cell table seen during the build.
+        std::size_t peakGridBytes{};
+
+        PlacementCounters placement{};
+    };
+
+    /// <summary>
+    /// Adds the time from construction to destruction to a phase total.
+    /// Does nothing when statistics are compiled out. Only the clock reads are compiled out, so the layout
+    /// is the same whether or not a translation unit enables statistics.
+    /// </summary>
+    class ScopedPhaseTimer
+    {
+        std::chrono::nanoseconds& m_total;
+        std::chrono::steady_clock::time_point m_start{};
+
+    public:
+        explicit ScopedPhaseTimer(std::chrono::nanoseconds& total) :
+            m_total{ total }
+        {
+            if constexpr (ARE_STATS_ENABLED)
+            {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedPhaseTimer()
+        {
+            if constexpr (ARE_STATS_ENABLED)
+            {
+                m_total += std::chrono::steady_clock::now() - m_start;
+            }
+        }
+
+        ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+        ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+    };
+
+    struct LabyrinthResult;
+
+    /// <summary>
+    /// Write the build's statistics as one JSON object followed by a newline, so a file of builds is JSON lines.
+    /// The seed and dimensions are included to tell levels apart, and the build status by name to tell why a build stopped.
+    /// Times are in nanoseconds.
+    /// </summary>
+    void writeStatsJsonLine(const LabyrinthResult& result, std::ostream& out);
+
+    void runLabyrinthStatsTests();
+}
@@ -0,0 +1,74 @@
+#include "Logging.h"
+
+#include "SelfTest.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        void writeToStandardError(LogLevel, std::string_view message)
+        {
+            std::cerr << message << "\n";
+        }
+    }
+
+    Logger::Logger() :
+        m_sink{ writeToStandardError }
+    {
+    }
+
+    void Logger::setLevel(LogLevel level)
+    {
+        m_level = level;
+    }
+
+    LogLevel Logger::getLevel() const
+    {
+        return m_level;
+    }
+
+    void Logger::setSink(LogSink sink)
+    {
+        m_sink = sink ? std::move(sink) : LogSink{ writeToStandardError };
+    }
+
+    bool Logger::isEnabled(LogLevel level) const
+    {
+        return level != LogLevel::None && level <= m_level;
+    }
+
+    void Logger::write(LogLevel level, std::string_view message) const
+    {
+        if (isEnabled(level))
+        {
+            m_sink(level, message);
+        }
+    }
+
+    void runLoggingTests()
+    {
+        std::vector<std::string> messages{};
+
+        Logger logger{};
+        logger.setSink([&messages](LogLevel, std::string_view message) { messages.emplace_back(message); });
+
+        // Warning is the default level.
+        logger.write(LogLevel::Warning, "warning");
+        logger.write(LogLevel::Info, "info");
+        LABYRINTH_CHECK((std::vector<std::string>{ "warning" }) == messages);
+
+        logger.setLevel(LogLevel::Debug);
+        LABYRINTH_CHECK(logger.isEnabled(LogLevel::Info));
+        logger.write(LogLevel::Debug, "debug");
+        LABYRINTH_CHECK(2 == messages.size() && "debug" == messages.back());
+
+        logger.setLevel(LogLevel::None);
+        LABYRINTH_CHECK(!logger.isEnabled(LogLevel::Warning));
+        logger.write(LogLevel::Warning, "silenced");
+        LABYRINTH_CHECK(2 == messages.size());
+    }
+}
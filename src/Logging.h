@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <string_view>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// How much diagnostic output to produce. Each level includes the ones before it.
+    /// </summary>
+    enum class LogLevel
+    {
+        None,
+        Warning,
+        Info,
+        Debug
+    };
+
+    /// <summary>
+    /// Receives every diagnostic message at or below the logger's level.
+    /// </summary>
+    using LogSink = std::function<void(LogLevel level, std::string_view message)>;
+
+    /// <summary>
+    /// Filters diagnostic messages by level and hands the rest to a sink.
+    /// By default warnings are written to std::cerr.
+    /// </summary>
+    class Logger
+    {
+        LogLevel m_level{ LogLevel::Warning };
+        LogSink m_sink;
+
+    public:
+        Logger();
+
+        void setLevel(LogLevel level);
+        LogLevel getLevel() const;
+
+        /// <summary>
+        /// An empty sink restores the default one.
+        /// </summary>
+        void setSink(LogSink sink);
+
+        /// <summary>
+        /// Check before building an expensive message.
+        /// </summary>
+        bool isEnabled(LogLevel level) const;
+
+        void write(LogLevel level, std::string_view message) const;
+    };
+
+    void runLoggingTests();
+}
@@ -0,0 +1,240 @@
+#include "MappedFile.h"
+
+#include "SelfTest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LabyrinthGeneration
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& path)
+    {
+        HANDLE file{ CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error{ "MappedFile could not open " + path };
+        }
+        m_fileHandle = file;
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            close();
+            throw std::runtime_error{ "MappedFile could not read the size of " + path };
+        }
+        m_size = static_cast<std::size_t>(fileSize.QuadPart);
+
+        // Windows cannot map an empty file.
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mappingHandle == nullptr)
+        {
+            close();
+            throw std::runtime_error{ "MappedFile could not map " + path };
+        }
+
+        m_data = static_cast<const std::byte*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == nullptr)
+        {
+            close();
+            throw std::runtime_error{ "MappedFile could not map " + path };
+        }
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mappingHandle != nullptr)
+        {
+            CloseHandle(m_mappingHandle);
+        }
+
+        if (m_fileHandle != nullptr)
+        {
+            CloseHandle(m_fileHandle);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_mappingHandle = nullptr;
+        m_fileHandle = nullptr;
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept :
+        m_data{ std::exchange(other.m_data, nullptr) },
+        m_size{ std::exchange(other.m_size, 0) },
+        m_fileHandle{ std::exchange(other.m_fileHandle, nullptr) },
+        m_mappingHandle{ std::exchange(other.m_mappingHandle, nullptr) }
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+            m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+        }
+
+        return *this;
+    }
+#else
+    MappedFile::MappedFile(const std::string& path)
+    {
+        m_fileDescriptor = ::open(path.c_str(), O_RDONLY);
+        if (m_fileDescriptor < 0)
+        {
+            throw std::runtime_error{ "MappedFile could not open " + path };
+        }
+
+        struct stat fileStatus{};
+        if (::fstat(m_fileDescriptor, &fileStatus) != 0)
+        {
+            close();
+            throw std::runtime_error{ "MappedFile could not read the size of " + path };
+        }
+        m_size = static_cast<std::size_t>(fileStatus.st_size);
+
+        // mmap rejects a length of zero.
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        void* mapping{ ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0) };
+        if (mapping == MAP_FAILED)
+        {
+            close();
+            throw std::runtime_error{ "MappedFile could not map " + path };
+        }
+
+        m_data = static_cast<const std::byte*>(mapping);
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data != nullptr)
+        {
+            ::munmap(const_cast<std::byte*>(m_data), m_size);
+        }
+
+        if (m_fileDescriptor >= 0)
+        {
+            ::close(m_fileDescriptor);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_fileDescriptor = -1;
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept :
+        m_data{ std::exchange(other.m_data, nullptr) },
+        m_size{ std::exchange(other.m_size, 0) },
+        m_fileDescriptor{ std::exchange(other.m_fileDescriptor, -1) }
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_fileDescriptor = std::exchange(other.m_fileDescriptor, -1);
+        }
+
+        return *this;
+    }
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    const std::byte* MappedFile::data() const
+    {
+        return m_data;
+    }
+
+    std::size_t MappedFile::size() const
+    {
+        return m_size;
+    }
+
+    void runMappedFileTests()
+    {
+        std::filesystem::path path{ std::filesystem::temp_directory_path() / "LabyrinthGenerationMappedFileTest.bin" };
+
+        {
+            std::ofstream out{ path, std::ios::binary };
+            out << "labyrinth";
+        }
+
+        {
+            MappedFile file{ path.string() };
+            LABYRINTH_CHECK(9 == file.size());
+            LABYRINTH_CHECK(std::byte{ 'l' } == file.data()[0]);
+            LABYRINTH_CHECK(std::byte{ 'h' } == file.data()[8]);
+
+            // Moving hands over the mapping.
+            MappedFile moved{ std::move(file) };
+            LABYRINTH_CHECK(nullptr == file.data());
+            LABYRINTH_CHECK(9 == moved.size());
+        }
+
+        {
+            std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+        }
+
+        {
+            MappedFile empty{ path.string() };
+            LABYRINTH_CHECK(0 == empty.size());
+            LABYRINTH_CHECK(nullptr == empty.data());
+        }
+
+        std::filesystem::remove(path);
+
+        bool caught{ false };
+        try
+        {
+            MappedFile missing{ path.string() };
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        LABYRINTH_CHECK(caught);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// A whole file mapped read-only into memory.
+    ///
+    /// The operating system pages the file in as it is read, so opening costs the same no matter how big the file is.
+    /// </summary>
+    class MappedFile
+    {
+        const std::byte* m_data{ nullptr };
+        std::size_t m_size{};
+
+#ifdef _WIN32
+        void* m_fileHandle{ nullptr };
+        void* m_mappingHandle{ nullptr };
+#else
+        int m_fileDescriptor{ -1 };
+#endif
+
+    public:
+        MappedFile() = default;
+
+        /// <summary>
+        /// Throws std::runtime_error if the file cannot be opened or mapped.
+        /// </summary>
+        explicit MappedFile(const std::string& path);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        ~MappedFile();
+
+        /// <summary>
+        /// Null for an empty file.
+        /// </summary>
+        const std::byte* data() const;
+        std::size_t size() const;
+
+    private:
+        void close();
+    };
+
+    void runMappedFileTests();
+}
@@ -0,0 +1,328 @@
+#include "OccupancyBitboard.h"
+
+#include "Grid.h"
+#include "SelfTest.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <random>
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        const std::uint64_t ALL_BITS{ ~std::uint64_t{ 0 } };
+
+        // The words a run of columns covers, with masks selecting its columns within the first and last word.
+        struct WordSpan
+        {
+            int firstWord{};
+            int lastWord{};
+            std::uint64_t firstMask{};
+            std::uint64_t lastMask{};
+        };
+
+        WordSpan makeWordSpan(int minX, int sizeX)
+        {
+            int maxX{ minX + sizeX - 1 };
+
+            WordSpan span{
+                minX / OccupancyBitboard::CELLS_PER_WORD,
+                maxX / OccupancyBitboard::CELLS_PER_WORD,
+                ALL_BITS << (minX % OccupancyBitboard::CELLS_PER_WORD),
+                ALL_BITS >> (OccupancyBitboard::CELLS_PER_WORD - 1 - (maxX % OccupancyBitboard::CELLS_PER_WORD)) };
+
+            // A run within one word only needs one mask.
+            if (span.firstWord == span.lastWord)
+            {
+                span.firstMask &= span.lastMask;
+            }
+
+            return span;
+        }
+    }
+
+    OccupancyBitboard::OccupancyBitboard(VectorIntXY dimensions) :
+        m_dimensions{ dimensions },
+        m_wordsPerRow{ (std::max(dimensions.x, 0) + CELLS_PER_WORD - 1) / CELLS_PER_WORD }
+    {
+        m_words.assign(static_cast<std::size_t>(m_wordsPerRow) * static_cast<std::size_t>(std::max(dimensions.y, 0)), 0);
+    }
+
+    void OccupancyBitboard::clear()
+    {
+        std::fill(m_words.begin(), m_words.end(), 0);
+    }
+
+    void OccupancyBitboard::setBlocked(VectorIntXY cell)
+    {
+        assert(cell.x >= 0 && cell.x < m_dimensions.x && cell.y >= 0 && cell.y < m_dimensions.y);
+
+        std::size_t word{ (static_cast<std::size_t>(cell.y) * m_wordsPerRow) + (cell.x / CELLS_PER_WORD) };
+        m_words[word] |= std::uint64_t{ 1 } << (cell.x % CELLS_PER_WORD);
+    }
+
+    void OccupancyBitboard::setBlocked(VectorIntXY min, VectorIntXY size)
+    {
+        if (size.x < 1 || size.y < 1) { return; }
+
+        assert(min.x >= 0 && min.y >= 0 && min.x + size.x <= m_dimensions.x && min.y + size.y <= m_dimensions.y);
+
+        WordSpan span{ makeWordSpan(min.x, size.x) };
+
+        for (int y = min.y; y < min.y + size.y; y++)
+        {
+            std::uint64_t* words{ m_words.data() + (static_cast<std::size_t>(y) * m_wordsPerRow) };
+
+            words[span.firstWord] |= span.firstMask;
+            if (span.firstWord == span.lastWord)
+            {
+                continue;
+            }
+
+            for (int word = span.firstWord + 1; word < span.lastWord; word++)
+            {
+                words[word] = ALL_BITS;
+            }
+
+            words[span.lastWord] |= span.lastMask;
+        }
+    }
+
+    bool OccupancyBitboard::isBlocked(VectorIntXY cell) const
+    {
+        assert(cell.x >= 0 && cell.x < m_dimensions.x && cell.y >= 0 && cell.y < m_dimensions.y);
+
+        std::size_t word{ (static_cast<std::size_t>(cell.y) * m_wordsPerRow) + (cell.x / CELLS_PER_WORD) };
+        return (m_words[word] >> (cell.x % CELLS_PER_WORD)) & 1;
+    }
+
+    bool OccupancyBitboard::isRectangleOpen(VectorIntXY min, VectorIntXY size) const
+    {
+        assert(size.x >= 1 && size.y >= 1);
+        assert(min.x >= 0 && min.y >= 0 && min.x + size.x <= m_dimensions.x && min.y + size.y <= m_dimensions.y);
+
+        WordSpan span{ makeWordSpan(min.x, size.x) };
+
+        for (int y = min.y; y < min.y + size.y; y++)
+        {
+            const std::uint64_t* words{ row(y) };
+
+            if (words[span.firstWord] & span.firstMask)
+            {
+                return false;
+            }
+
+            if (span.firstWord == span.lastWord)
+            {
+                continue;
+            }
+
+            for (int word = span.firstWord + 1; word < span.lastWord; word++)
+            {
+                if (words[word])
+                {
+                    return false;
+                }
+            }
+
+            if (words[span.lastWord] & span.lastMask)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::optional<VectorIntXY> OccupancyBitboard::findOpenRectangle(VectorIntXY size, VectorIntXY maxMinCorner) const
+    {
+        assert(size.x >= 1 && size.y >= 1);
+        assert(maxMinCorner.x + size.x <= m_dimensions.x && maxMinCorner.y + size.y <= m_dimensions.y);
+
+        for (int y = 0; y <= maxMinCorner.y; y++)
+        {
+            // No position overlapping a blocked column fits, so continue from the column after it.
+            int x{ 0 };
+            while (x <= maxMinCorner.x)
+            {
+                int lastBlocked{ findLastBlockedColumn(VectorIntXY{ x, y }, size) };
+                if (lastBlocked < 0)
+                {
+                    return VectorIntXY{ x, y };
+                }
+
+                x = lastBlocked + 1;
+            }
+        }
+
+        return {};
+    }
+
+    int OccupancyBitboard::findLastBlockedColumn(VectorIntXY min, VectorIntXY size) const
+    {
+        WordSpan span{ makeWordSpan(min.x, size.x) };
+
+        for (int word = span.lastWord; word >= span.firstWord; word--)
+        {
+            std::uint64_t blocked{ 0 };
+            for (int y = min.y; y < min.y + size.y; y++)
+            {
+                blocked |= row(y)[word];
+            }
+
+            if (word == span.lastWord)
+            {
+                blocked &= span.lastMask;
+            }
+            if (word == span.firstWord)
+            {
+                blocked &= span.firstMask;
+            }
+
+            if (blocked)
+            {
+                return (word * CELLS_PER_WORD) + (CELLS_PER_WORD - 1 - std::countl_zero(blocked));
+            }
+        }
+
+        return -1;
+    }
+
+    const VectorIntXY& OccupancyBitboard::getDimensions() const
+    {
+        return m_dimensions;
+    }
+
+    int OccupancyBitboard::getWordsPerRow() const
+    {
+        return m_wordsPerRow;
+    }
+
+    const std::uint64_t* OccupancyBitboard::row(int y) const
+    {
+        return m_words.data() + (static_cast<std::size_t>(y) * m_wordsPerRow);
+    }
+
+    std::size_t OccupancyBitboard::getMemoryUsage() const
+    {
+        return m_words.size() * sizeof(std::uint64_t);
+    }
+
+    void runOccupancyBitboardTests()
+    {
+        // Wide enough for rectangles within one word, across two and across three.
+        VectorIntXY dimensions{ 150, 9 };
+        OccupancyBitboard board{ dimensions };
+        LABYRINTH_CHECK(3 == board.getWordsPerRow());
+        LABYRINTH_CHECK(3 * 9 * sizeof(std::uint64_t) == board.getMemoryUsage());
+        LABYRINTH_CHECK(board.isRectangleOpen(VectorIntXY{ 0, 0 }, dimensions));
+
+        board.setBlocked(VectorIntXY{ 63, 2 });
+        LABYRINTH_CHECK(board.isBlocked(VectorIntXY{ 63, 2 }));
+        LABYRINTH_CHECK(!board.isBlocked(VectorIntXY{ 64, 2 }));
+        LABYRINTH_CHECK(std::uint64_t{ 1 } << 63 == board.row(2)[0]);
+        LABYRINTH_CHECK(!board.isRectangleOpen(VectorIntXY{ 60, 0 }, VectorIntXY{ 10, 3 }));
+        LABYRINTH_CHECK(board.isRectangleOpen(VectorIntXY{ 64, 0 }, VectorIntXY{ 86, 9 }));
+        LABYRINTH_CHECK(board.isRectangleOpen(VectorIntXY{ 0, 3 }, VectorIntXY{ 150, 6 }));
+
+        // A rectangle spanning three words fills the middle one and masks the ends.
+        board.setBlocked(VectorIntXY{ 60, 5 }, VectorIntXY{ 80, 2 });
+        LABYRINTH_CHECK(ALL_BITS == board.row(5)[1]);
+        LABYRINTH_CHECK(ALL_BITS << 60 == board.row(6)[0]);
+        LABYRINTH_CHECK(ALL_BITS >> (64 - 12) == board.row(6)[2]);
+        LABYRINTH_CHECK(!board.isBlocked(VectorIntXY{ 140, 5 }));
+        LABYRINTH_CHECK(board.isBlocked(VectorIntXY{ 139, 6 }));
+
+        // Padding bits past the end of a row stay clear, so rows can be compared word by word.
+        board.setBlocked(VectorIntXY{ 140, 8 }, VectorIntXY{ 10, 1 });
+        LABYRINTH_CHECK(ALL_BITS >> (64 - 22) == (board.row(8)[2] | (ALL_BITS >> (64 - 12))));
+
+        // The first open rectangle in row order skips past blocked columns in every word of the row band.
+        {
+            OccupancyBitboard scanBoard{ VectorIntXY{ 150, 6 } };
+            scanBoard.setBlocked(VectorIntXY{ 65, 0 });
+            scanBoard.setBlocked(VectorIntXY{ 100, 3 });
+            scanBoard.setBlocked(VectorIntXY{ 0, 1 }, VectorIntXY{ 40, 1 });
+
+            LABYRINTH_CHECK(VectorIntXY(66, 0) == scanBoard.findOpenRectangle(VectorIntXY{ 60, 2 }, VectorIntXY{ 90, 4 }).value());
+            LABYRINTH_CHECK(VectorIntXY(40, 1) == scanBoard.findOpenRectangle(VectorIntXY{ 90, 2 }, VectorIntXY{ 59, 4 }).value());
+            LABYRINTH_CHECK(VectorIntXY(0, 2) == scanBoard.findOpenRectangle(VectorIntXY{ 90, 4 }, VectorIntXY{ 59, 2 }).value());
+            LABYRINTH_CHECK(!scanBoard.findOpenRectangle(VectorIntXY{ 100, 5 }, VectorIntXY{ 49, 1 }).has_value());
+        }
+
+        // Interleave rectangle updates with queries and compare against brute force checks.
+        Grid<int> reference{ dimensions, 0, 0 };
+        OccupancyBitboard randomBoard{ dimensions };
+        std::mt19937 random{ 54321 };
+
+        auto randomRectangle = [&](VectorIntXY& min, VectorIntXY& size)
+            {
+                min = VectorIntXY{
+                    std::uniform_int_distribution<int>{ 0, dimensions.x - 1 }(random),
+                    std::uniform_int_distribution<int>{ 0, dimensions.y - 1 }(random) };
+                size = VectorIntXY{
+                    std::uniform_int_distribution<int>{ 1, std::min(dimensions.x - min.x, 70) }(random),
+                    std::uniform_int_distribution<int>{ 1, dimensions.y - min.y }(random) };
+            };
+
+        for (int i = 0; i < 300; i++)
+        {
+            VectorIntXY min{};
+            VectorIntXY size{};
+
+            // Blocked cells should stay sparse, so most queries are not trivially blocked.
+            if (i % 10 == 0)
+            {
+                randomRectangle(min, size);
+                size = VectorIntXY{ std::min(size.x, 5), std::min(size.y, 2) };
+                randomBoard.setBlocked(min, size);
+                for (int y = min.y; y < min.y + size.y; y++)
+                {
+                    for (int x = min.x; x < min.x + size.x; x++)
+                    {
+                        reference(x, y) = 1;
+                    }
+                }
+            }
+
+            randomRectangle(min, size);
+
+            bool expected{ true };
+            for (int y = min.y; y < min.y + size.y; y++)
+            {
+                for (int x = min.x; x < min.x + size.x; x++)
+                {
+                    expected = expected && reference(x, y) == 0;
+                }
+            }
+
+            LABYRINTH_CHECK(expected == randomBoard.isRectangleOpen(min, size));
+
+            if (i % 10 == 5)
+            {
+                VectorIntXY scanSize{ std::min(size.x, 20), std::min(size.y, 4) };
+                VectorIntXY maxMinCorner{ dimensions.x - scanSize.x, dimensions.y - scanSize.y };
+
+                std::optional<VectorIntXY> expectedCorner{};
+                for (int y = 0; y <= maxMinCorner.y && !expectedCorner; y++)
+                {
+                    for (int x = 0; x <= maxMinCorner.x && !expectedCorner; x++)
+                    {
+                        if (randomBoard.isRectangleOpen(VectorIntXY{ x, y }, scanSize))
+                        {
+                            expectedCorner = VectorIntXY{ x, y };
+                        }
+                    }
+                }
+
+                LABYRINTH_CHECK(expectedCorner == randomBoard.findOpenRectangle(scanSize, maxMinCorner));
+            }
+        }
+
+        randomBoard.clear();
+        LABYRINTH_CHECK(randomBoard.isRectangleOpen(VectorIntXY{ 0, 0 }, dimensions));
+        LABYRINTH_CHECK(!(board == randomBoard));
+    }
+}
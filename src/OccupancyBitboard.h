@@ -0,0 +1,82 @@
+#pragma once
+
+#include "VectorIntXY.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// One bit per cell telling whether a cell is blocked.
+    ///
+    /// Each row starts on a fresh 64 bit word, with bit i of a word holding the cell i columns past the word's first cell.
+    /// Testing or blocking a rectangle touches one word per 64 columns of each of its rows,
+    /// masking off the columns outside the rectangle in the first and last word.
+    /// Padding bits past the end of a row are always clear.
+    /// </summary>
+    class OccupancyBitboard
+    {
+        std::vector<std::uint64_t> m_words{};
+        VectorIntXY m_dimensions{};
+        int m_wordsPerRow{};
+
+    public:
+        static constexpr int CELLS_PER_WORD{ 64 };
+
+        OccupancyBitboard() = default;
+        explicit OccupancyBitboard(VectorIntXY dimensions);
+
+        /// <summary>
+        /// Mark every cell as open.
+        /// </summary>
+        void clear();
+
+        void setBlocked(VectorIntXY cell);
+
+        /// <summary>
+        /// Block every cell of the rectangle with the given minimum corner and size.
+        /// The rectangle must lie within the grid.
+        /// </summary>
+        void setBlocked(VectorIntXY min, VectorIntXY size);
+
+        bool isBlocked(VectorIntXY cell) const;
+
+        /// <summary>
+        /// Whether no cell of the rectangle with the given minimum corner and size is blocked.
+        /// The rectangle must lie within the grid. Only reads the words, so several threads can test at once.
+        /// </summary>
+        bool isRectangleOpen(VectorIntXY min, VectorIntXY size) const;
+
+        /// <summary>
+        /// Minimum corner of the first open rectangle of the given size in row order,
+        /// with minimum corners up to and including maxMinCorner, or nothing if none is open.
+        /// Each row band skips past the last blocked column of a rejected position, a word at a time.
+        /// </summary>
+        std::optional<VectorIntXY> findOpenRectangle(VectorIntXY size, VectorIntXY maxMinCorner) const;
+
+        const VectorIntXY& getDimensions() const;
+
+        int getWordsPerRow() const;
+
+        /// <summary>
+        /// The words of row y, getWordsPerRow() of them. Lets the occupancy be saved or compared without unpacking it.
+        /// </summary>
+        const std::uint64_t* row(int y) const;
+
+        /// <summary>
+        /// Bytes of cell storage in use.
+        /// </summary>
+        std::size_t getMemoryUsage() const;
+
+        friend bool operator==(const OccupancyBitboard& left, const OccupancyBitboard& right) = default;
+
+    private:
+        // Last blocked column of the rectangle with the given minimum corner and size, or -1 if it is open.
+        int findLastBlockedColumn(VectorIntXY min, VectorIntXY size) const;
+    };
+
+    void runOccupancyBitboardTests();
+}
@@ -0,0 +1,504 @@
+#include "PlacementIndex.h"
+
+#include "Grid.h"
+#include "SelfTest.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <set>
+#include <utility>
+
+namespace LabyrinthGeneration
+{
+    namespace
+    {
+        // Rectangle of positions, empty when min is past max along either axis.
+        struct PositionBounds
+        {
+            VectorIntXY min{};
+            VectorIntXY max{};
+        };
+
+        bool isEmpty(const PositionBounds& bounds)
+        {
+            return bounds.max.x < bounds.min.x || bounds.max.y < bounds.min.y;
+        }
+
+        std::size_t getArea(const PositionBounds& bounds)
+        {
+            if (isEmpty(bounds))
+            {
+                return 0;
+            }
+
+            return static_cast<std::size_t>(bounds.max.x - bounds.min.x + 1) * static_cast<std::size_t>(bounds.max.y - bounds.min.y + 1);
+        }
+
+        // Positions from (0, 0) to maxPosition at most distance steps from center along x and y.
+        PositionBounds getBoundsWithin(VectorIntXY center, VectorIntXY maxPosition, int distance)
+        {
+            return PositionBounds{
+                VectorIntXY{ std::max(center.x - distance, 0), std::max(center.y - distance, 0) },
+                VectorIntXY{ std::min(center.x + distance, maxPosition.x), std::min(center.y + distance, maxPosition.y) } };
+        }
+
+        /// <summary>
+        /// The positions of one ring, split into four strips: the rows below the inner rings, the rows above them,
+        /// then the columns left and right of them on the rows they cover. Each strip is stored row by row.
+        /// </summary>
+        struct RingStrips
+        {
+            PositionBounds outer{};
+            PositionBounds inner{};
+            std::size_t start{};
+            std::size_t width{};
+            std::size_t bottomCount{};
+            std::size_t topCount{};
+            std::size_t leftCount{};
+            int leftWidth{};
+            int rightWidth{};
+
+            RingStrips(VectorIntXY center, VectorIntXY maxPosition, int ring) :
+                outer{ getBoundsWithin(center, maxPosition, ring) },
+                inner{ getBoundsWithin(center, maxPosition, ring - 1) },
+                start{ getArea(inner) }
+            {
+                // With no inner rings in the labyrinth, the whole ring is one bottom strip.
+                if (isEmpty(inner))
+                {
+                    inner.min = VectorIntXY{ outer.min.x, outer.max.y + 1 };
+                    inner.max = VectorIntXY{ outer.min.x - 1, outer.max.y };
+                }
+
+                std::size_t innerHeight{ static_cast<std::size_t>(inner.max.y - inner.min.y + 1) };
+                width = static_cast<std::size_t>(std::max(outer.max.x - outer.min.x + 1, 0));
+                leftWidth = inner.min.x - outer.min.x;
+                rightWidth = outer.max.x - inner.max.x;
+
+                bottomCount = static_cast<std::size_t>(inner.min.y - outer.min.y) * width;
+                topCount = static_cast<std::size_t>(outer.max.y - inner.max.y) * width;
+                leftCount = innerHeight * static_cast<std::size_t>(leftWidth);
+            }
+        };
+
+        // Index of the set bit with the given number of set bits below it.
+        int selectBit(std::uint64_t word, std::size_t setBitsBefore)
+        {
+            for (std::size_t i = 0; i < setBitsBefore; i++)
+            {
+                word &= word - 1;
+            }
+
+            return std::countr_zero(word);
+        }
+    }
+
+    PlacementIndex::PlacementIndex(VectorIntXY labyrinthDimensions, VectorIntXY footprint) :
+        m_footprint{ footprint },
+        m_maxPosition{ labyrinthDimensions.x - 1 - footprint.x, labyrinthDimensions.y - 1 - footprint.y },
+        m_center{ (labyrinthDimensions.x / 2) - (footprint.x / 2), (labyrinthDimensions.y / 2) - (footprint.y / 2) }
+    {
+        if (m_maxPosition.x < 0 || m_maxPosition.y < 0)
+        {
+            return;
+        }
+
+        int farthestRing{ std::max({
+            std::abs(m_center.x),
+            std::abs(m_maxPosition.x - m_center.x),
+            std::abs(m_center.y),
+            std::abs(m_maxPosition.y - m_center.y) }) };
+        m_ringCount = farthestRing + 1;
+
+        std::size_t wordCount{ (getRingStart(m_ringCount) + POSITIONS_PER_WORD - 1) / POSITIONS_PER_WORD };
+        assert(getRingStart(m_ringCount) == static_cast<std::size_t>(m_maxPosition.x + 1) * static_cast<std::size_t>(m_maxPosition.y + 1));
+        m_words.resize(wordCount);
+        m_tree.resize(wordCount + 1);
+        m_treeTopStep = std::bit_floor(wordCount);
+
+        reset();
+    }
+
+    void PlacementIndex::reset()
+    {
+        m_openCount = 0;
+
+        if (m_ringCount == 0)
+        {
+            return;
+        }
+
+        // Every place in ring order belongs to a position, so the first openCount bits are set.
+        m_openCount = static_cast<std::size_t>(m_maxPosition.x + 1) * static_cast<std::size_t>(m_maxPosition.y + 1);
+        std::fill(m_words.begin(), m_words.end(), ~std::uint64_t{ 0 });
+
+        int lastWordBits{ static_cast<int>(m_openCount % POSITIONS_PER_WORD) };
+        if (lastWordBits > 0)
+        {
+            m_words.back() = (std::uint64_t{ 1 } << lastWordBits) - 1;
+        }
+
+        // Build the tree in place: every entry passes its count on to the next entry covering it.
+        m_tree[0] = 0;
+        for (std::size_t i = 1; i < m_tree.size(); i++)
+        {
+            m_tree[i] = static_cast<std::uint32_t>(std::popcount(m_words[i - 1]));
+        }
+
+        for (std::size_t i = 1; i < m_tree.size(); i++)
+        {
+            std::size_t parent{ i + (i & (0 - i)) };
+            if (parent < m_tree.size())
+            {
+                m_tree[parent] += m_tree[i];
+            }
+        }
+    }
+
+    void PlacementIndex::setBlocked(VectorIntXY cell)
+    {
+        setBlocked(cell, VectorIntXY{ 1, 1 });
+    }
+
+    void PlacementIndex::setBlocked(VectorIntXY min, VectorIntXY size)
+    {
+        if (size.x < 1 || size.y < 1 || m_openCount == 0)
+        {
+            return;
+        }
+
+        // Footprints with a minimum corner in this range overlap the rectangle.
+        VectorIntXY first{
+            std::max(min.x - m_footprint.x + 1, 0),
+            std::max(min.y - m_footprint.y + 1, 0) };
+        VectorIntXY last{
+            std::min(min.x + size.x - 1, m_maxPosition.x),
+            std::min(min.y + size.y - 1, m_maxPosition.y) };
+
+        for (int y = first.y; y <= last.y; y++)
+        {
+            for (int x = first.x; x <= last.x; x++)
+            {
+                std::size_t order{ getOrder(VectorIntXY{ x, y }) };
+                std::size_t word{ order / POSITIONS_PER_WORD };
+                std::uint64_t bit{ std::uint64_t{ 1 } << (order % POSITIONS_PER_WORD) };
+
+                if (m_words[word] & bit)
+                {
+                    m_words[word] &= ~bit;
+                    removeFromTree(word);
+                    m_openCount--;
+                }
+            }
+        }
+    }
+
+    bool PlacementIndex::isOpen(VectorIntXY position) const
+    {
+        if (position.x < 0 || position.y < 0 || position.x > m_maxPosition.x || position.y > m_maxPosition.y)
+        {
+            return false;
+        }
+
+        std::size_t order{ getOrder(position) };
+        return (m_words[order / POSITIONS_PER_WORD] >> (order % POSITIONS_PER_WORD)) & 1;
+    }
+
+    std::size_t PlacementIndex::getOpenCount() const
+    {
+        return m_openCount;
+    }
+
+    std::size_t PlacementIndex::getNearestRingOpenCount() const
+    {
+        if (m_openCount == 0)
+        {
+            return 0;
+        }
+
+        // The first open position in ring order is in the nearest ring with any, and no open position comes before it.
+        int ring{ getRingOfOrder(findOpen(0)) };
+        return countOpenBefore(getRingStart(ring + 1));
+    }
+
+    VectorIntXY PlacementIndex::getNearestRingOpenPosition(std::size_t index) const
+    {
+        return getPosition(findOpen(index));
+    }
+
+    int PlacementIndex::getRing(VectorIntXY position) const
+    {
+        return std::max(std::abs(position.x - m_center.x), std::abs(position.y - m_center.y));
+    }
+
+    const VectorIntXY& PlacementIndex::getFootprint() const
+    {
+        return m_footprint;
+    }
+
+    const VectorIntXY& PlacementIndex::getCenter() const
+    {
+        return m_center;
+    }
+
+    std::size_t PlacementIndex::getMemoryUsage() const
+    {
+        return (m_words.size() * sizeof(std::uint64_t)) + (m_tree.size() * sizeof(std::uint32_t));
+    }
+
+    std::size_t PlacementIndex::getRingStart(int ring) const
+    {
+        return getArea(getBoundsWithin(m_center, m_maxPosition, ring - 1));
+    }
+
+    int PlacementIndex::getRingOfOrder(std::size_t order) const
+    {
+        // The last ring starting at or before the order. Rings with no positions start where the next one does.
+        int first{ 0 };
+        int last{ m_ringCount - 1 };
+        while (first < last)
+        {
+            int middle{ first + ((last - first + 1) / 2) };
+            if (getRingStart(middle) <= order)
+            {
+                first = middle;
+            }
+            else
+            {
+                last = middle - 1;
+            }
+        }
+
+        return first;
+    }
+
+    std::size_t PlacementIndex::getOrder(VectorIntXY position) const
+    {
+        RingStrips strips{ m_center, m_maxPosition, getRing(position) };
+        std::size_t x{ static_cast<std::size_t>(position.x) };
+        std::size_t y{ static_cast<std::size_t>(position.y) };
+        std::size_t along{ strips.start };
+
+        if (position.y < strips.inner.min.y)
+        {
+            return along + ((y - static_cast<std::size_t>(strips.outer.min.y)) * strips.width) + x - static_cast<std::size_t>(strips.outer.min.x);
+        }
+
+        along += strips.bottomCount;
+        if (position.y > strips.inner.max.y)
+        {
+            return along + ((y - static_cast<std::size_t>(strips.inner.max.y + 1)) * strips.width) + x - static_cast<std::size_t>(strips.outer.min.x);
+        }
+
+        along += strips.topCount;
+        std::size_t row{ y - static_cast<std::size_t>(strips.inner.min.y) };
+        if (position.x < strips.inner.min.x)
+        {
+            return along + (row * static_cast<std::size_t>(strips.leftWidth)) + x - static_cast<std::size_t>(strips.outer.min.x);
+        }
+
+        along += strips.leftCount;
+        return along + (row * static_cast<std::size_t>(strips.rightWidth)) + x - static_cast<std::size_t>(strips.inner.max.x + 1);
+    }
+
+    VectorIntXY PlacementIndex::getPosition(std::size_t order) const
+    {
+        RingStrips strips{ m_center, m_maxPosition, getRingOfOrder(order) };
+        std::size_t along{ order - strips.start };
+
+        auto inStrip = [](VectorIntXY min, std::size_t stripWidth, std::size_t offset)
+            {
+                return min + VectorIntXY{ static_cast<int>(offset % stripWidth), static_cast<int>(offset / stripWidth) };
+            };
+
+        if (along < strips.bottomCount)
+        {
+            return inStrip(strips.outer.min, strips.width, along);
+        }
+
+        along -= strips.bottomCount;
+        if (along < strips.topCount)
+        {
+            return inStrip(VectorIntXY{ strips.outer.min.x, strips.inner.max.y + 1 }, strips.width, along);
+        }
+
+        along -= strips.topCount;
+        if (along < strips.leftCount)
+        {
+            return inStrip(VectorIntXY{ strips.outer.min.x, strips.inner.min.y }, static_cast<std::size_t>(strips.leftWidth), along);
+        }
+
+        along -= strips.leftCount;
+        return inStrip(VectorIntXY{ strips.inner.max.x + 1, strips.inner.min.y }, static_cast<std::size_t>(strips.rightWidth), along);
+    }
+
+    std::size_t PlacementIndex::countOpenBefore(std::size_t order) const
+    {
+        std::size_t word{ order / POSITIONS_PER_WORD };
+        std::size_t count{ 0 };
+
+        for (std::size_t i = word; i > 0; i -= i & (0 - i))
+        {
+            count += m_tree[i];
+        }
+
+        int bit{ static_cast<int>(order % POSITIONS_PER_WORD) };
+        if (bit > 0)
+        {
+            count += static_cast<std::size_t>(std::popcount(m_words[word] & ((std::uint64_t{ 1 } << bit) - 1)));
+        }
+
+        return count;
+    }
+
+    std::size_t PlacementIndex::findOpen(std::size_t openBefore) const
+    {
+        assert(openBefore < m_openCount);
+
+        // Walk down the tree to the last word with at most openBefore open positions before it.
+        std::size_t word{ 0 };
+        for (std::size_t step = m_treeTopStep; step > 0; step >>= 1)
+        {
+            if (word + step < m_tree.size() && m_tree[word + step] <= openBefore)
+            {
+                word += step;
+                openBefore -= m_tree[word];
+            }
+        }
+
+        return (word * POSITIONS_PER_WORD) + static_cast<std::size_t>(selectBit(m_words[word], openBefore));
+    }
+
+    void PlacementIndex::removeFromTree(std::size_t word)
+    {
+        for (std::size_t i = word + 1; i < m_tree.size(); i += i & (0 - i))
+        {
+            m_tree[i]--;
+        }
+    }
+
+    void runPlacementIndexTests()
+    {
+        // A fresh index has every position open, and the only position in ring 0 is the centre.
+        VectorIntXY dimensions{ 37, 22 };
+        VectorIntXY footprint{ 5, 3 };
+        PlacementIndex index{ dimensions, footprint };
+        LABYRINTH_CHECK(index.getCenter() == VectorIntXY(16, 10));
+        LABYRINTH_CHECK(index.getOpenCount() == 32 * 19);
+        LABYRINTH_CHECK(index.isOpen(VectorIntXY{ 0, 0 }));
+        LABYRINTH_CHECK(index.isOpen(VectorIntXY{ 31, 18 }));
+        LABYRINTH_CHECK(!index.isOpen(VectorIntXY{ 32, 18 }));
+
+        Xoshiro256StarStar randomEngine{ 7 };
+        LABYRINTH_CHECK(index.pickNearCenter(randomEngine) == index.getCenter());
+
+        // Blocking one cell closes every position whose footprint covers it, and no others.
+        index.setBlocked(VectorIntXY{ 18, 11 });
+        LABYRINTH_CHECK(index.getOpenCount() == (32 * 19) - (5 * 3));
+        LABYRINTH_CHECK(!index.isOpen(VectorIntXY{ 14, 9 }));
+        LABYRINTH_CHECK(!index.isOpen(VectorIntXY{ 18, 11 }));
+        LABYRINTH_CHECK(index.isOpen(VectorIntXY{ 13, 9 }));
+        LABYRINTH_CHECK(index.isOpen(VectorIntXY{ 14, 8 }));
+        LABYRINTH_CHECK(index.isOpen(VectorIntXY{ 19, 11 }));
+
+        // Every open position of the nearest ring gets picked.
+        PlacementIndex single{ VectorIntXY{ 9, 9 }, VectorIntXY{ 1, 1 } };
+        single.setBlocked(single.getCenter());
+        std::set<std::pair<int, int>> picked{};
+        for (std::uint64_t stream = 0; stream < 200; stream++)
+        {
+            Xoshiro256StarStar streamEngine{ deriveStream(11, stream) };
+            VectorIntXY position{ single.pickNearCenter(streamEngine).value() };
+            LABYRINTH_CHECK(single.getRing(position) == 1);
+            picked.insert({ position.x, position.y });
+        }
+        LABYRINTH_CHECK(picked.size() == 8);
+
+        // A footprint with no room for its one cell margin fits nowhere.
+        PlacementIndex tooLarge{ VectorIntXY{ 6, 6 }, VectorIntXY{ 6, 2 } };
+        LABYRINTH_CHECK(tooLarge.getOpenCount() == 0);
+        LABYRINTH_CHECK(!tooLarge.pickNearCenter(randomEngine).has_value());
+
+        // A long, narrow labyrinth stores one bit per position, not a square of rings around the centre.
+        PlacementIndex narrow{ VectorIntXY{ 4000, 12 }, VectorIntXY{ 3, 3 } };
+        std::size_t narrowPositions{ 3997 * 9 };
+        LABYRINTH_CHECK(narrow.getOpenCount() == narrowPositions);
+        LABYRINTH_CHECK(narrow.getMemoryUsage() <= ((narrowPositions / PlacementIndex::POSITIONS_PER_WORD) + 2) * (sizeof(std::uint64_t) + sizeof(std::uint32_t)));
+        narrow.setBlocked(VectorIntXY{ 1900, 0 }, VectorIntXY{ 200, 12 });
+        VectorIntXY narrowPick{ narrow.pickNearCenter(randomEngine).value() };
+        LABYRINTH_CHECK(narrowPick.x == 2100 && narrow.getRing(narrowPick) == 101);
+        LABYRINTH_CHECK(narrow.isOpen(narrowPick));
+
+        // Interleave blocking with picks and compare against brute force checks, until nothing fits.
+        Grid<int> reference{ dimensions, 0, 0 };
+        std::mt19937 random{ 2468 };
+
+        auto isReferenceOpen = [&](VectorIntXY position)
+            {
+                for (int y = position.y; y < position.y + footprint.y; y++)
+                {
+                    for (int x = position.x; x < position.x + footprint.x; x++)
+                    {
+                        if (reference(x, y) != 0) { return false; }
+                    }
+                }
+
+                return true;
+            };
+
+        index.reset();
+        for (int round = 0; index.getOpenCount() > 0; round++)
+        {
+            LABYRINTH_CHECK(round < 1000);
+
+            VectorIntXY min{
+                std::uniform_int_distribution<int>{ 0, dimensions.x - 1 }(random),
+                std::uniform_int_distribution<int>{ 0, dimensions.y - 1 }(random) };
+            VectorIntXY size{
+                std::uniform_int_distribution<int>{ 1, std::min(dimensions.x - min.x, 4) }(random),
+                std::uniform_int_distribution<int>{ 1, std::min(dimensions.y - min.y, 2) }(random) };
+
+            index.setBlocked(min, size);
+            for (int y = min.y; y < min.y + size.y; y++)
+            {
+                for (int x = min.x; x < min.x + size.x; x++)
+                {
+                    reference(x, y) = 1;
+                }
+            }
+
+            std::size_t openCount{ 0 };
+            int nearestRing{ std::numeric_limits<int>::max() };
+            for (int y = 0; y <= dimensions.y - 1 - footprint.y; y++)
+            {
+                for (int x = 0; x <= dimensions.x - 1 - footprint.x; x++)
+                {
+                    VectorIntXY position{ x, y };
+                    bool isOpen{ isReferenceOpen(position) };
+                    LABYRINTH_CHECK(isOpen == index.isOpen(position));
+
+                    if (isOpen)
+                    {
+                        openCount++;
+                        nearestRing = std::min(nearestRing, index.getRing(position));
+                    }
+                }
+            }
+            LABYRINTH_CHECK(openCount == index.getOpenCount());
+
+            std::optional<VectorIntXY> position{ index.pickNearCenter(randomEngine) };
+            LABYRINTH_CHECK(position.has_value() == (openCount > 0));
+            if (position.has_value())
+            {
+                LABYRINTH_CHECK(isReferenceOpen(position.value()));
+                LABYRINTH_CHECK(index.getRing(position.value()) == nearestRing);
+            }
+        }
+
+        LABYRINTH_CHECK(!index.pickNearCenter(randomEngine).has_value());
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Random.h"
+#include "VectorIntXY.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Every position where a footprint of one size fits, kept up to date as cells are blocked.
+    /// A position is the footprint's minimum corner, from (0, 0) to the maximum position,
+    /// which keeps the cell one past the footprint's maximum corner within the labyrinth as search rays do.
+    ///
+    /// Positions are ordered ring by ring around the centre position, where the footprint is centred in the labyrinth,
+    /// and stored one bit each in that order. Rings are clipped to the positions, so storage follows the labyrinth's shape. A Fenwick tree counts the open positions of every 64 bit word,
+    /// so finding the nearest ring with an open position and picking any open position in it take logarithmic time.
+    /// Cells can only go from open to blocked, and blocking a cell closes at most one footprint's area of positions.
+    /// </summary>
+    class PlacementIndex
+    {
+        VectorIntXY m_footprint{};
+        VectorIntXY m_maxPosition{};
+        VectorIntXY m_center{};
+
+        // Rings around the centre out to the farthest position. Ring r holds the positions r steps away
+        // along x or y, whichever is farther. Only positions within the labyrinth have a place in the order.
+        int m_ringCount{};
+
+        // Bit i of word w is set if position number (64 * w) + i in ring order is open.
+        std::vector<std::uint64_t> m_words{};
+
+        // Fenwick tree over the words, from index 1. Entry i counts the open positions of the words
+        // from i - (i & -i) to i - 1.
+        std::vector<std::uint32_t> m_tree{};
+
+        // Largest power of two no greater than the number of words. Where a search down the tree starts.
+        std::size_t m_treeTopStep{};
+
+        std::size_t m_openCount{};
+
+    public:
+        static constexpr int POSITIONS_PER_WORD{ 64 };
+
+        PlacementIndex() = default;
+        PlacementIndex(VectorIntXY labyrinthDimensions, VectorIntXY footprint);
+
+        /// <summary>
+        /// Mark every position as open.
+        /// </summary>
+        void reset();
+
+        void setBlocked(VectorIntXY cell);
+
+        /// <summary>
+        /// Close every position where the footprint would overlap the rectangle with the given minimum corner and size.
+        /// </summary>
+        void setBlocked(VectorIntXY min, VectorIntXY size);
+
+        bool isOpen(VectorIntXY position) const;
+
+        /// <summary>
+        /// Number of positions where the footprint fits. Zero means it fits nowhere.
+        /// </summary>
+        std::size_t getOpenCount() const;
+
+        /// <summary>
+        /// An open position in the nearest ring to the centre that has any, each equally likely,
+        /// or nothing if the footprint fits nowhere.
+        /// </summary>
+        template <typename Engine>
+        std::optional<VectorIntXY> pickNearCenter(Engine& engine) const
+        {
+            std::size_t ringOpenCount{ getNearestRingOpenCount() };
+            if (ringOpenCount == 0)
+            {
+                return {};
+            }
+
+            return getNearestRingOpenPosition(randomIndex(engine, ringOpenCount));
+        }
+
+        /// <summary>
+        /// Ring of a position: how many steps it is from the centre position along x or y, whichever is farther.
+        /// </summary>
+        int getRing(VectorIntXY position) const;
+
+        const VectorIntXY& getFootprint() const;
+        const VectorIntXY& getCenter() const;
+
+        /// <summary>
+        /// Bytes of position and tree storage in use.
+        /// </summary>
+        std::size_t getMemoryUsage() const;
+
+    private:
+        // Open positions in the nearest ring to the centre that has any, or zero if the footprint fits nowhere.
+        std::size_t getNearestRingOpenCount() const;
+
+        // Open position number index, in ring order, of the nearest ring that has any.
+        VectorIntXY getNearestRingOpenPosition(std::size_t index) const;
+
+        // Place in ring order of the first position of the ring: the number of positions in the rings inside it.
+        std::size_t getRingStart(int ring) const;
+        int getRingOfOrder(std::size_t order) const;
+
+        std::size_t getOrder(VectorIntXY position) const;
+        VectorIntXY getPosition(std::size_t order) const;
+
+        // Open positions before the given place in ring order.
+        std::size_t countOpenBefore(std::size_t order) const;
+
+        // Place in ring order of the open position with the given number of open positions before it.
+        std::size_t findOpen(std::size_t openBefore) const;
+
+        void removeFromTree(std::size_t word);
+    };
+
+    void runPlacementIndexTests();
+}
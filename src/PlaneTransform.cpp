@@ -1,6 +1,7 @@
 #include "PlaneTransform.h"
 
-#include <cassert>
+#include "SelfTest.h"
+
 #include <cmath>
 
 namespace LabyrinthGeneration
@@ -55,13 +56,13 @@ namespace LabyrinthGeneration
         Vector3 position{ transform.getPosition() };
         VectorXY forward{ transform.getForward() };
 
-        assert(
+        LABYRINTH_CHECK(
             position.x == 1 &&
             position.y == 2 &&
             position.z == 3
         );
 
-        assert(
+        LABYRINTH_CHECK(
             forward.x == (1 / std::sqrt(2)) &&
             forward.y == (1 / std::sqrt(2))
         );
@@ -72,13 +73,13 @@ namespace LabyrinthGeneration
         position = transform.getPosition();
         forward = transform.getForward();
 
-        assert(
+        LABYRINTH_CHECK(
             position.x == 4 &&
             position.y == 5 &&
             position.z == 6
         );
 
-        assert(
+        LABYRINTH_CHECK(
             forward.x == -(1 / std::sqrt(2)) &&
             forward.y == -(1 / std::sqrt(2))
         );
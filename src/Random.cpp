@@ -0,0 +1,62 @@
+#include "Random.h"
+
+#include "SelfTest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    void runRandomTests()
+    {
+        // Reference outputs of SplitMix64 seeded with zero.
+        SplitMix64 splitMix{ 0 };
+        LABYRINTH_CHECK(0xE220A8397B1DCDAFull == splitMix.next());
+        LABYRINTH_CHECK(0x6E789E6AA1B965F4ull == splitMix.next());
+        LABYRINTH_CHECK(0x06C45D188009454Full == splitMix.next());
+
+        // The same seed gives the same sequence, and reseeding restarts it.
+        Xoshiro256StarStar engine{ 7 };
+        Xoshiro256StarStar sameSeed{ 7 };
+        std::uint64_t first{ engine() };
+        LABYRINTH_CHECK(first == sameSeed());
+        LABYRINTH_CHECK(engine == sameSeed);
+
+        engine.seed(7);
+        LABYRINTH_CHECK(first == engine());
+        LABYRINTH_CHECK(Xoshiro256StarStar{ 8 }() != first);
+
+        // Doubles stay in range and average out to the middle.
+        double sum{ 0 };
+        const int sampleCount{ 100000 };
+        for (int i = 0; i < sampleCount; i++)
+        {
+            double value{ randomDouble(engine, -1.0, 1.0) };
+            LABYRINTH_CHECK(value >= -1.0 && value < 1.0);
+            sum += value;
+        }
+        LABYRINTH_CHECK(std::abs(sum / sampleCount) < 0.01);
+
+        // Indices stay in range and cover every value.
+        std::vector<int> counts(5, 0);
+        for (int i = 0; i < 1000; i++)
+        {
+            std::uint64_t index{ randomIndex(engine, 5) };
+            LABYRINTH_CHECK(index < 5);
+            counts[index]++;
+        }
+        for (int count : counts)
+        {
+            LABYRINTH_CHECK(count > 100);
+        }
+        LABYRINTH_CHECK(0 == randomIndex(engine, 1));
+
+        // Derived streams do not depend on the order they are derived in, and differ from each other.
+        Xoshiro256StarStar laterStream{ deriveStream(7, 5) };
+        Xoshiro256StarStar earlierStream{ deriveStream(7, 2) };
+        LABYRINTH_CHECK(laterStream == deriveStream(7, 5));
+        LABYRINTH_CHECK(earlierStream == deriveStream(7, 2));
+        LABYRINTH_CHECK(!(laterStream == earlierStream));
+        LABYRINTH_CHECK(!(deriveStream(7, 2) == deriveStream(8, 2)));
+    }
+}
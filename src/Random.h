@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// SplitMix64 generator. Every seed, even zero or neighbouring seeds, gives well mixed output,
+    /// which makes it a good way to expand one seed into the state of a larger generator.
+    /// </summary>
+    class SplitMix64
+    {
+        std::uint64_t m_state;
+
+    public:
+        explicit SplitMix64(std::uint64_t seed) : m_state{ seed } {}
+
+        std::uint64_t next()
+        {
+            std::uint64_t value{ m_state += 0x9E3779B97F4A7C15ull };
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            return value ^ (value >> 31);
+        }
+    };
+
+    /// <summary>
+    /// xoshiro256** generator by Blackman and Vigna. Small, fast, and specified down to the bit,
+    /// so a seed gives the same sequence with every compiler and standard library.
+    /// Meets the requirements of a standard uniform random bit generator.
+    /// </summary>
+    class Xoshiro256StarStar
+    {
+        std::uint64_t m_state[4]{};
+
+    public:
+        using result_type = std::uint64_t;
+
+        explicit Xoshiro256StarStar(std::uint64_t seed = 0) { this->seed(seed); }
+
+        /// <summary>
+        /// The four state words are the first outputs of SplitMix64 seeded with the seed.
+        /// </summary>
+        void seed(std::uint64_t seed)
+        {
+            SplitMix64 seeder{ seed };
+            for (std::uint64_t& word : m_state)
+            {
+                word = seeder.next();
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            result_type result{ rotateLeft(m_state[1] * 5, 7) * 9 };
+            std::uint64_t shifted{ m_state[1] << 17 };
+
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= shifted;
+            m_state[3] = rotateLeft(m_state[3], 45);
+
+            return result;
+        }
+
+        friend bool operator==(const Xoshiro256StarStar& left, const Xoshiro256StarStar& right) = default;
+
+    private:
+        static std::uint64_t rotateLeft(std::uint64_t value, int shift)
+        {
+            return (value << shift) | (value >> (64 - shift));
+        }
+    };
+
+    /// <summary>
+    /// Uniform double in [0, 1) from the top 53 bits of one engine output.
+    /// Unlike std::uniform_real_distribution, the mapping is the same on every platform.
+    /// </summary>
+    template <typename Engine>
+    double randomUnitDouble(Engine& engine)
+    {
+        static_assert(Engine::min() == 0 && Engine::max() == std::numeric_limits<std::uint64_t>::max(),
+            "Engine must produce 64 random bits");
+
+        return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+    }
+
+    /// <summary>
+    /// Uniform double in [min, max).
+    /// </summary>
+    template <typename Engine>
+    double randomDouble(Engine& engine, double min, double max)
+    {
+        return min + ((max - min) * randomUnitDouble(engine));
+    }
+
+    /// <summary>
+    /// Uniform integer in [0, count), without modulo bias. Count must not be zero.
+    /// </summary>
+    template <typename Engine>
+    std::uint64_t randomIndex(Engine& engine, std::uint64_t count)
+    {
+        static_assert(Engine::min() == 0 && Engine::max() == std::numeric_limits<std::uint64_t>::max(),
+            "Engine must produce 64 random bits");
+
+        // Reject the lowest 2^64 mod count values, so every remainder is equally likely.
+        std::uint64_t threshold{ (0 - count) % count };
+        while (true)
+        {
+            std::uint64_t value{ engine() };
+            if (value >= threshold)
+            {
+                return value % count;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Seed of stream number streamIndex of a master seed.
+    /// Streams are counter based: any stream can be derived directly, in any order or on any thread,
+    /// without drawing from the streams before it.
+    /// </summary>
+    inline std::uint64_t deriveSeed(std::uint64_t masterSeed, std::uint64_t streamIndex)
+    {
+        return SplitMix64{ SplitMix64{ masterSeed }.next() ^ streamIndex }.next();
+    }
+
+    /// <summary>
+    /// Engine for stream number streamIndex of a master seed. Any engine seeded from one 64 bit value works.
+    /// </summary>
+    template <typename Engine = Xoshiro256StarStar>
+    Engine deriveStream(std::uint64_t masterSeed, std::uint64_t streamIndex)
+    {
+        return Engine{ deriveSeed(masterSeed, streamIndex) };
+    }
+
+    void runRandomTests();
+}
@@ -1,6 +1,7 @@
 #include "Room.h"
 
-#include <cassert>
+#include "SelfTest.h"
+
 
 namespace LabyrinthGeneration
 {
@@ -31,15 +32,15 @@ namespace LabyrinthGeneration
         Vector3 originalDimensions{ room.getDimensions() };
 
         // Verify data encapsulation for position
-        assert(dimensions.x == 10);
-        assert(originalDimensions.x == 1);
+        LABYRINTH_CHECK(dimensions.x == 10);
+        LABYRINTH_CHECK(originalDimensions.x == 1);
 
         std::vector<PlaneTransform> doors{ room.getDoors() };
         doors.push_back(PlaneTransform{ Vector3{2.1, 2.2, 2.3}, VectorXY{2.4, 2.5} });
         std::vector<PlaneTransform> originalDoors{ room.getDoors() };
 
         // Verify data encapsulation for doors
-        assert(3 == doors.size());
-        assert(2 == originalDoors.size());
+        LABYRINTH_CHECK(3 == doors.size());
+        LABYRINTH_CHECK(2 == originalDoors.size());
     }
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "RoomTemplate.h"
+
+#include "CellUnitConverter.h"
+#include "SelfTest.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace LabyrinthGeneration
+{
+    RoomTemplate::RoomTemplate(const Room& room, double cellUnit) :
+        m_cellUnit{ cellUnit }
+    {
+        if (cellUnit == 0)
+        {
+            throw std::runtime_error{ "RoomTemplate cell unit cannot be zero!" };
+        }
+
+        CellUnitConverter converter{ cellUnit };
+
+        const Vector3& dimensions{ room.getDimensions() };
+        m_footprint = VectorIntXY{ converter.metersToCellRound(dimensions.x), converter.metersToCellRound(dimensions.y) };
+
+        for (const PlaneTransform& door : room.getDoors())
+        {
+            // Move door position forward into an adjoining cell.
+            // The provided position is the door prefab spawn position.
+            // The forward direction of the provided transform indicates "out of the room"
+            // Adding half of a unit also accounts for float precision.
+            Vector3 doorPosition = door.getPosition();
+            VectorXY doorForward{ door.getForward().x, door.getForward().y };
+            Vector3 hallPosition = doorPosition + ((Vector3{ doorForward.x, doorForward.y, 0 } * 0.5f));
+
+            m_doorOffsets.push_back(VectorIntXY{
+                converter.metersToCellFloor(hallPosition.x),
+                converter.metersToCellFloor(hallPosition.y) });
+
+            m_doorDirections.push_back(VectorIntXY{
+                static_cast<int>(std::lround(doorForward.x)),
+                static_cast<int>(std::lround(doorForward.y)) });
+        }
+    }
+
+    double RoomTemplate::getCellUnit() const
+    {
+        return m_cellUnit;
+    }
+
+    const VectorIntXY& RoomTemplate::getFootprint() const
+    {
+        return m_footprint;
+    }
+
+    const std::vector<VectorIntXY>& RoomTemplate::getDoorOffsets() const
+    {
+        return m_doorOffsets;
+    }
+
+    const std::vector<VectorIntXY>& RoomTemplate::getDoorDirections() const
+    {
+        return m_doorDirections;
+    }
+
+    void runRoomTemplateTests()
+    {
+        Room room
+        {
+            Vector3{6, 6, 3},
+            {
+                PlaneTransform{ Vector3{3, 0, 0}, VectorXY{0, -1} },
+                PlaneTransform{ Vector3{3, 6, 0}, VectorXY{0, 1} },
+                PlaneTransform{ Vector3{0, 3, 0}, VectorXY{-1, 0} },
+                PlaneTransform{ Vector3{6, 3, 0}, VectorXY{1, 0} },
+            }
+        };
+
+        RoomTemplate roomTemplate{ room, 2.0 };
+
+        LABYRINTH_CHECK(2.0 == roomTemplate.getCellUnit());
+        LABYRINTH_CHECK(VectorIntXY(3, 3) == roomTemplate.getFootprint());
+
+        const std::vector<VectorIntXY>& doorOffsets{ roomTemplate.getDoorOffsets() };
+        LABYRINTH_CHECK(4 == doorOffsets.size());
+        LABYRINTH_CHECK(VectorIntXY(1, -1) == doorOffsets[0]);
+        LABYRINTH_CHECK(VectorIntXY(1, 3) == doorOffsets[1]);
+        LABYRINTH_CHECK(VectorIntXY(-1, 1) == doorOffsets[2]);
+        LABYRINTH_CHECK(VectorIntXY(3, 1) == doorOffsets[3]);
+
+        const std::vector<VectorIntXY>& doorDirections{ roomTemplate.getDoorDirections() };
+        LABYRINTH_CHECK(VectorIntXY(0, -1) == doorDirections[0]);
+        LABYRINTH_CHECK(VectorIntXY(0, 1) == doorDirections[1]);
+        LABYRINTH_CHECK(VectorIntXY(-1, 0) == doorDirections[2]);
+        LABYRINTH_CHECK(VectorIntXY(1, 0) == doorDirections[3]);
+
+        // The same room at a finer cell unit covers more cells.
+        RoomTemplate fineTemplate{ room, 1.0 };
+        LABYRINTH_CHECK(VectorIntXY(6, 6) == fineTemplate.getFootprint());
+        LABYRINTH_CHECK(VectorIntXY(3, -1) == fineTemplate.getDoorOffsets()[0]);
+    }
+}
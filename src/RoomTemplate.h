@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Room.h"
+#include "VectorIntXY.h"
+
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// A room converted to cell space for one cell unit.
+    ///
+    /// Holds the room's footprint in cells, and for each door the cell just outside it
+    /// and the direction it faces, relative to the room's minimum corner.
+    /// Converting once lets the builder place rooms with integer offsets only.
+    /// A template can be shared by any number of builders that use the same cell unit.
+    /// </summary>
+    class RoomTemplate
+    {
+        double m_cellUnit;
+        VectorIntXY m_footprint;
+        std::vector<VectorIntXY> m_doorOffsets{};
+        std::vector<VectorIntXY> m_doorDirections{};
+
+    public:
+        RoomTemplate(const Room& room, double cellUnit);
+
+        double getCellUnit() const;
+
+        const VectorIntXY& getFootprint() const;
+
+        /// <summary>
+        /// Offset from the room's minimum corner to the hallway cell outside each door.
+        /// </summary>
+        const std::vector<VectorIntXY>& getDoorOffsets() const;
+
+        /// <summary>
+        /// Direction each door faces, out of the room, rounded to whole cells.
+        /// </summary>
+        const std::vector<VectorIntXY>& getDoorDirections() const;
+    };
+
+    void runRoomTemplateTests();
+}
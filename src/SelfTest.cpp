@@ -0,0 +1,13 @@
+#include "SelfTest.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace LabyrinthGeneration
+{
+    void failSelfTestCheck(const char* condition, const char* file, int line)
+    {
+        std::cerr << file << ":" << line << ": Self test check failed: " << condition << std::endl;
+        std::abort();
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+/// <summary>
+/// Check an expectation of a self test. Unlike assert, checks stay on when NDEBUG is defined,
+/// so the self tests can run against a release build of the library.
+/// </summary>
+#define LABYRINTH_CHECK(condition) \
+    ((condition) ? static_cast<void>(0) : ::LabyrinthGeneration::failSelfTestCheck(#condition, __FILE__, __LINE__))
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Report a failed self test check on std::cerr and abort.
+    /// </summary>
+    [[noreturn]] void failSelfTestCheck(const char* condition, const char* file, int line);
+}
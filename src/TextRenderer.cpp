@@ -0,0 +1,96 @@
+#include "TextRenderer.h"
+
+#include "SelfTest.h"
+
+#include <charconv>
+#include <sstream>
+
+namespace LabyrinthGeneration
+{
+    void TextRenderer::render(const DistanceField& distanceField, std::ostream& out)
+    {
+        const VectorIntXY& dimensions{ distanceField.getDimensions() };
+
+        for (int y = 0; y < dimensions.y; y++)
+        {
+            m_row.clear();
+
+            // print row number
+            appendNumber(static_cast<std::uint32_t>(y));
+
+            for (int x = 0; x < dimensions.x; x++)
+            {
+                // give ourselves a visual indication of every 5 columns
+                if (x % 5 == 0)
+                {
+                    m_row += " | ";
+                }
+
+                VectorIntXY cell{ x, y };
+                CellKind cellKind{ distanceField.getKind(cell) };
+
+                if (cellKind == CellKind::Room)
+                {
+                    m_row += "room  ";
+                }
+                else if (cellKind == CellKind::Hall)
+                {
+                    m_row += "hall  ";
+                }
+                else if (distanceField.getDistance(cell) == DistanceField::UNCALCULATED)
+                {
+                    m_row += "....  ";
+                }
+                else
+                {
+                    m_row += ' ';
+                    appendNumber(distanceField.getDistance(cell));
+                    m_row += "   ";
+                }
+            }
+
+            // on to the next row
+            m_row += '\n';
+            out.write(m_row.data(), static_cast<std::streamsize>(m_row.size()));
+        }
+    }
+
+    /// <summary>
+    /// Append a number with at least two digits, zero padded.
+    /// </summary>
+    void TextRenderer::appendNumber(std::uint32_t value)
+    {
+        char digits[16];
+        std::to_chars_result result{ std::to_chars(digits, digits + sizeof(digits), value) };
+
+        if (result.ptr - digits < 2)
+        {
+            m_row += '0';
+        }
+
+        m_row.append(digits, result.ptr);
+    }
+
+    void runTextRendererTests()
+    {
+        DistanceField distanceField{ VectorIntXY{ 6, 2 } };
+        distanceField.setKind(VectorIntXY{ 0, 0 }, VectorIntXY{ 2, 2 }, CellKind::Room);
+        distanceField.setKind(VectorIntXY{ 2, 0 }, CellKind::Hall);
+        distanceField.setKind(VectorIntXY{ 2, 1 }, CellKind::PotentialDoor);
+        distanceField.setKind(VectorIntXY{ 5, 1 }, CellKind::Room);
+        distanceField.propagate(std::vector<VectorIntXY>{ VectorIntXY{ 2, 0 }, VectorIntXY{ 2, 1 } }, 0);
+
+        std::ostringstream out{};
+        TextRenderer renderer{};
+        renderer.render(distanceField, out);
+
+        LABYRINTH_CHECK(out.str() ==
+            "00 | room  room  hall   01    02    |  03   \n"
+            "01 | room  room   00    01    02    | room  \n");
+
+        // Rendering again reuses the row buffer and gives the same text.
+        std::ostringstream again{};
+        renderer.render(distanceField, again);
+        LABYRINTH_CHECK(out.str() == again.str());
+    }
+}
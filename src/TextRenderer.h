@@ -0,0 +1,27 @@
+#pragma once
+
+#include "DistanceField.h"
+
+#include <ostream>
+#include <string>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Writes a distance field as a text grid: one line per row, with room, hall and distance cells.
+    ///
+    /// Each row is formatted into a reused buffer and written to the stream in one call.
+    /// </summary>
+    class TextRenderer
+    {
+        std::string m_row{};
+
+    public:
+        void render(const DistanceField& distanceField, std::ostream& out);
+
+    private:
+        void appendNumber(std::uint32_t value);
+    };
+
+    void runTextRendererTests();
+}
@@ -1,13 +1,14 @@
 #include "Vector3.h"
 
-#include <cassert>
+#include "SelfTest.h"
+
 #include <iostream>
 
 namespace LabyrinthGeneration
 {
     std::string Vector3::toString() const
     {
-        return "(" + 
+        return std::string{ "(" } + 
             std::to_string(x) + ", " + 
             std::to_string(y) + ", " + 
             std::to_string(z) + ")";
@@ -59,6 +60,6 @@ namespace LabyrinthGeneration
     {
         Vector3 vec{ 1, 2, 3 };
 
-        assert("(1.000000, 2.000000, 3.000000)" == vec.toString());
+        LABYRINTH_CHECK("(1.000000, 2.000000, 3.000000)" == vec.toString());
     }
 }
\ No newline at end of file
@@ -1,13 +1,20 @@
 #include "VectorIntXY.h"
 
-#include <cassert>
+#include "SelfTest.h"
+
 #include <iostream>
 
 namespace LabyrinthGeneration
 {
     std::string VectorIntXY::toString() const
     {
-        return "(" + std::to_string(x) + ", " + std::to_string(y) + ")";
+        std::string text{ "(" };
+        text += std::to_string(x);
+        text += ", ";
+        text += std::to_string(y);
+        text += ")";
+
+        return text;
     }
 
     VectorIntXY operator+(const VectorIntXY& left, const VectorIntXY& right)
@@ -21,8 +28,8 @@ namespace LabyrinthGeneration
     VectorIntXY operator-(const VectorIntXY& left, const VectorIntXY& right)
     {
         return VectorIntXY{
-            left.x + right.x,
-            left.y + right.y
+            left.x - right.x,
+            left.y - right.y
         };
     }
 
@@ -49,8 +56,11 @@ namespace LabyrinthGeneration
         VectorIntXY vec2{ 3, 4 };
 
         std::string vecString{ vec.toString() };
-        assert("(3, 4)" == vec.toString());
-        assert(zero != vec);
-        assert(vec == vec2);
+        LABYRINTH_CHECK("(3, 4)" == vec.toString());
+        LABYRINTH_CHECK(zero != vec);
+        LABYRINTH_CHECK(vec == vec2);
+
+        LABYRINTH_CHECK(VectorIntXY(6, 8) == vec + vec2);
+        LABYRINTH_CHECK(VectorIntXY(2, 3) == vec - VectorIntXY(1, 1));
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "VectorXY.h"
 
-#include <cassert>
+#include "SelfTest.h"
+
 #include <iostream>
 
 namespace LabyrinthGeneration
@@ -13,7 +14,13 @@ namespace LabyrinthGeneration
 
     std::string VectorXY::toString() const
     {
-        return "(" + std::to_string(x) + ", " + std::to_string(y) + ")";
+        std::string text{ "(" };
+        text += std::to_string(x);
+        text += ", ";
+        text += std::to_string(y);
+        text += ")";
+
+        return text;
     }
 
     std::ostream& operator<<(std::ostream& os, const VectorXY& target)
@@ -27,9 +34,9 @@ namespace LabyrinthGeneration
         VectorXY zero{ 0, 0 };
         VectorXY vec{ 3.0, 4.0 };
 
-        assert(25.0 == vec.distanceSquared(zero, vec));
+        LABYRINTH_CHECK(25.0 == vec.distanceSquared(zero, vec));
 
         std::string vecString{ vec.toString() };
-        assert("(3.000000, 4.000000)" == vec.toString());
+        LABYRINTH_CHECK("(3.000000, 4.000000)" == vec.toString());
     }
 }
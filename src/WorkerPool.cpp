@@ -0,0 +1,166 @@
+#include "WorkerPool.h"
+
+#include "SelfTest.h"
+
+#include <stdexcept>
+
+namespace LabyrinthGeneration
+{
+    WorkerPool::WorkerPool(std::size_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        if (threadCount == 0)
+        {
+            threadCount = 1;
+        }
+
+        m_workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; i++)
+        {
+            m_workers.emplace_back(&WorkerPool::workerLoop, this, i);
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_isStopping = true;
+        }
+
+        m_workAvailable.notify_all();
+
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    std::size_t WorkerPool::getThreadCount() const
+    {
+        return m_workers.size();
+    }
+
+    void WorkerPool::parallelFor(std::size_t count, const Body& body)
+    {
+        if (count == 0) { return; }
+
+        std::lock_guard submitLock{ m_submitMutex };
+
+        std::unique_lock lock{ m_mutex };
+        m_body = &body;
+        m_count = count;
+        m_nextIndex.store(0);
+        m_busyWorkers = m_workers.size();
+        m_firstException = nullptr;
+        m_generation++;
+
+        m_workAvailable.notify_all();
+        m_workFinished.wait(lock, [this] { return m_busyWorkers == 0; });
+
+        m_body = nullptr;
+
+        if (m_firstException)
+        {
+            std::exception_ptr exception{ m_firstException };
+            m_firstException = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void WorkerPool::workerLoop(std::size_t workerIndex)
+    {
+        std::uint64_t seenGeneration{ 0 };
+
+        while (true)
+        {
+            const Body* body{ nullptr };
+            std::size_t count{};
+
+            {
+                std::unique_lock lock{ m_mutex };
+                m_workAvailable.wait(lock, [&] { return m_isStopping || m_generation != seenGeneration; });
+
+                if (m_isStopping) { return; }
+
+                seenGeneration = m_generation;
+                body = m_body;
+                count = m_count;
+            }
+
+            // Claim indices until the loop is exhausted.
+            for (std::size_t index = m_nextIndex.fetch_add(1); index < count; index = m_nextIndex.fetch_add(1))
+            {
+                try
+                {
+                    (*body)(index, workerIndex);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock{ m_mutex };
+                    if (!m_firstException)
+                    {
+                        m_firstException = std::current_exception();
+                    }
+                }
+            }
+
+            {
+                std::lock_guard lock{ m_mutex };
+                m_busyWorkers--;
+                if (m_busyWorkers == 0)
+                {
+                    m_workFinished.notify_one();
+                }
+            }
+        }
+    }
+
+    void runWorkerPoolTests()
+    {
+        WorkerPool pool{ 4 };
+        LABYRINTH_CHECK(4 == pool.getThreadCount());
+
+        // Every index is visited exactly once, and worker indices stay in range.
+        std::vector<int> visits(1000, 0);
+        std::atomic<bool> workerIndexInRange{ true };
+        pool.parallelFor(visits.size(), [&](std::size_t index, std::size_t workerIndex)
+            {
+                visits[index]++;
+                if (workerIndex >= 4) { workerIndexInRange = false; }
+            });
+
+        for (int visitCount : visits)
+        {
+            LABYRINTH_CHECK(1 == visitCount);
+        }
+        LABYRINTH_CHECK(workerIndexInRange);
+
+        // The pool can be reused for many loops.
+        std::atomic<std::size_t> sum{ 0 };
+        for (int i = 0; i < 100; i++)
+        {
+            pool.parallelFor(10, [&](std::size_t index, std::size_t) { sum += index; });
+        }
+        LABYRINTH_CHECK(4500 == sum);
+
+        // Exceptions are passed back to the caller.
+        bool caught{ false };
+        try
+        {
+            pool.parallelFor(10, [](std::size_t index, std::size_t)
+                {
+                    if (index == 3) { throw std::runtime_error{ "test" }; }
+                });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        LABYRINTH_CHECK(caught);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LabyrinthGeneration
+{
+    /// <summary>
+    /// Fixed set of worker threads that run indexed loops in parallel.
+    ///
+    /// Workers are started once and reused by every call to parallelFor,
+    /// so the pool can be used for many short loops without creating threads.
+    /// </summary>
+    class WorkerPool
+    {
+        using Body = std::function<void(std::size_t index, std::size_t workerIndex)>;
+
+        std::vector<std::thread> m_workers{};
+
+        // Serializes calls to parallelFor from different threads.
+        std::mutex m_submitMutex{};
+
+        std::mutex m_mutex{};
+        std::condition_variable m_workAvailable{};
+        std::condition_variable m_workFinished{};
+
+        const Body* m_body{ nullptr };
+        std::size_t m_count{};
+        std::atomic<std::size_t> m_nextIndex{};
+        std::size_t m_busyWorkers{};
+        std::uint64_t m_generation{};
+        bool m_isStopping{ false };
+
+        std::exception_ptr m_firstException{};
+
+    public:
+        /// <summary>
+        /// Start the given number of worker threads.
+        /// Zero uses one thread per hardware thread.
+        /// </summary>
+        explicit WorkerPool(std::size_t threadCount = 0);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        std::size_t getThreadCount() const;
+
+        /// <summary>
+        /// Call body(index, workerIndex) once for every index in [0, count) and wait for all calls to return.
+        /// workerIndex is in [0, getThreadCount()) and is never used by two calls at the same time,
+        /// so it can select per-worker scratch state.
+        /// The first exception thrown by body is rethrown once the loop has finished.
+        /// </summary>
+        void parallelFor(std::size_t count, const Body& body);
+
+    private:
+        void workerLoop(std::size_t workerIndex);
+    };
+
+    void runWorkerPoolTests();
+}
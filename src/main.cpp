@@ -1,22 +1,56 @@
+#include "AliasTable.h"
+#include "AllocationCounter.h"
+#include "BatchGenerator.h"
 #include "CellUnitConverter.h"
+#include "ChunkedGenerator.h"
+#include "DistanceField.h"
+#include "Grid.h"
+#include "GridRay.h"
 #include "LabyrinthBuilder.h"
+#include "LabyrinthFile.h"
+#include "LabyrinthStats.h"
+#include "Logging.h"
+#include "MappedFile.h"
+#include "OccupancyBitboard.h"
+#include "PlacementIndex.h"
 #include "PlaneTransform.h"
+#include "Random.h"
 #include "Room.h"
+#include "RoomTemplate.h"
+#include "TextRenderer.h"
 #include "Vector3.h"
 #include "VectorIntXY.h"
 #include "VectorXY.h"
+#include "WorkerPool.h"
 
 using namespace LabyrinthGeneration;
 
 int main()
 {
+    runAllocationCounterTests();
     runVectorXYTests();
     runVectorIntXYTests();
     runCellUnitConverterTests();
+    runGridTests();
     runVector3Tests();
     runPlaneTransformTests();
     runRoomTests();
+    runRoomTemplateTests();
+    runRandomTests();
+    runGridRayTests();
+    runAliasTableTests();
+    runOccupancyBitboardTests();
+    runPlacementIndexTests();
+    runDistanceFieldTests();
+    runTextRendererTests();
+    runLoggingTests();
+    runLabyrinthStatsTests();
     runLabyrinthBuilderTests();
+    runWorkerPoolTests();
+    runBatchGeneratorTests();
+    runChunkedGeneratorTests();
+    runMappedFileTests();
+    runLabyrinthFileTests();
 
     return 0;
 }